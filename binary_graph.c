@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "graph_partition.h"
+#include "input_file.h"
+#include "binary_graph.h"
+
+static int host_is_little_endian(void) {
+    uint16_t probe = 1;
+    return *(uint8_t *)&probe == 1;
+}
+
+static uint64_t align_offset(uint64_t offset) {
+    return (offset + BINARY_GRAPH_ALIGN - 1) & ~(uint64_t)(BINARY_GRAPH_ALIGN - 1);
+}
+
+static void write_aligned(FILE *f, uint64_t offset, const void *array, size_t bytes) {
+    static const char zeros[BINARY_GRAPH_ALIGN] = {0};
+    long pos = ftell(f);
+    fwrite(zeros, 1, offset - pos, f);
+    fwrite(array, 1, bytes, f);
+}
+
+int is_binary_graph(const char *data, size_t size) {
+    return size >= sizeof(BinaryGraphHeader) && memcmp(data, BINARY_GRAPH_MAGIC, 4) == 0;
+}
+
+void write_binary_graph(const char *filename, int vertex_count) {
+    if (!host_is_little_endian()) {
+        printf("Blad: Format binarny grafu wymaga architektury little-endian.\n");
+        exit(14);
+    }
+
+    FILE *f = fopen(filename, "wb");
+    if (!f) {
+        printf("Blad: bledne dane wejsciowe.");
+        exit(14);
+    }
+
+    int *x_coords = malloc(vertex_count * sizeof(int));
+    int *row_offsets = calloc(row_count + 1, sizeof(int));
+    int *adj_offsets = malloc((vertex_count + 1) * sizeof(int));
+    if (!x_coords || !row_offsets || !adj_offsets) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    // offsety wierszy odtwarzamy z y wierzcholkow, a sasiadow zapisujemy juz po deduplikacji
+    adj_offsets[0] = 0;
+    for (int i = 0; i < vertex_count; i++) {
+        x_coords[i] = vertices[i].x;
+        row_offsets[vertices[i].y + 1]++;
+        adj_offsets[i + 1] = adj_offsets[i] + vertices[i].edge_num;
+    }
+    for (int r = 0; r < row_count; r++) row_offsets[r + 1] += row_offsets[r];
+
+    BinaryGraphHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BINARY_GRAPH_MAGIC, 4);
+    header.version = BINARY_GRAPH_VERSION;
+    header.vertex_count = vertex_count;
+    header.row_count = row_count;
+    header.max_matrix = max_matrix;
+    header.entry_count = adj_offsets[vertex_count];
+    header.x_offset = align_offset(sizeof(header));
+    header.rows_offset = align_offset(header.x_offset + (uint64_t)vertex_count * sizeof(int32_t));
+    header.adj_offsets_offset = align_offset(header.rows_offset + (uint64_t)(row_count + 1) * sizeof(int32_t));
+    header.adjacency_offset = align_offset(header.adj_offsets_offset + (uint64_t)(vertex_count + 1) * sizeof(int32_t));
+
+    fwrite(&header, sizeof(header), 1, f);
+    write_aligned(f, header.x_offset, x_coords, vertex_count * sizeof(int32_t));
+    write_aligned(f, header.rows_offset, row_offsets, (row_count + 1) * sizeof(int32_t));
+    write_aligned(f, header.adj_offsets_offset, adj_offsets, (vertex_count + 1) * sizeof(int32_t));
+    for (int i = 0; i < vertex_count; i++) {
+        if (i == 0) write_aligned(f, header.adjacency_offset, vertices[i].conn, vertices[i].edge_num * sizeof(int32_t));
+        else fwrite(vertices[i].conn, sizeof(int32_t), vertices[i].edge_num, f);
+    }
+
+    if (ferror(f)) {
+        printf("Blad: Nie udalo sie zapisac pliku binarnego grafu.\n");
+        exit(14);
+    }
+    fclose(f);
+
+    free(x_coords);
+    free(row_offsets);
+    free(adj_offsets);
+}
+
+void read_binary_graph(char *data, size_t size, int *vertex_count, int parts, double error_margin) {
+    BinaryGraphHeader *header = (BinaryGraphHeader *)data;
+    if (!host_is_little_endian() || header->version != BINARY_GRAPH_VERSION) {
+        printf("Blad: Nieobslugiwana wersja binarnego pliku grafu.\n");
+        exit(13);
+    }
+
+    uint64_t n = header->vertex_count;
+    uint64_t rows = header->row_count;
+    if (n == 0 || n > INT32_MAX || rows > INT32_MAX || header->entry_count > INT32_MAX ||
+        header->x_offset + n * sizeof(int32_t) > size ||
+        header->rows_offset + (rows + 1) * sizeof(int32_t) > size ||
+        header->adj_offsets_offset + (n + 1) * sizeof(int32_t) > size ||
+        header->adjacency_offset + (uint64_t)header->entry_count * sizeof(int32_t) > size ||
+        (header->x_offset | header->rows_offset | header->adj_offsets_offset | header->adjacency_offset) % sizeof(int32_t) != 0) {
+        printf("Blad: Niepoprawny format binarnego pliku grafu (uszkodzony naglowek).\n");
+        exit(13);
+    }
+
+    // tablice uzywamy bezposrednio ze zmapowanego pliku, bez kopiowania
+    int *x_coords = (int *)(data + header->x_offset);
+    int *row_offsets = (int *)(data + header->rows_offset);
+    int *adj_offsets = (int *)(data + header->adj_offsets_offset);
+    int *adj = (int *)(data + header->adjacency_offset);
+
+    if (adj_offsets[0] != 0 || adj_offsets[n] != (int)header->entry_count) {
+        printf("Blad: Niepoprawny format binarnego pliku grafu (uszkodzone offsety sasiadow).\n");
+        exit(13);
+    }
+
+    // te same warunki co parser tekstowy (check_value) - jeden przebieg O(V+E) przed budowa wierzcholkow
+    for (uint64_t i = 0; i < n; i++) check_value(LINE_X, x_coords[i], 0, (int)i, 0);
+    for (uint64_t y = 0; y <= rows; y++) check_value(LINE_Y, row_offsets[y], y > 0 ? row_offsets[y - 1] : 0, (int)y, 0);
+    for (uint64_t i = 0; i <= n; i++) check_value(LINE_OFFSETS, adj_offsets[i], i > 0 ? adj_offsets[i - 1] : 0, (int)i, (int)header->entry_count);
+    for (uint64_t j = 0; j < header->entry_count; j++) check_value(LINE_CONN, adj[j], 0, (int)j, (int)n);
+
+    max_matrix = header->max_matrix;
+    row_count = rows;
+    validate_graph_data(max_matrix, n, row_offsets, rows + 1, parts, error_margin);
+
+    *vertex_count = n;
+    vertices = malloc(*vertex_count * sizeof(Vertex));
+    if (!vertices) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    for (int i = 0; i < *vertex_count; i++) {
+        vertices[i].x = x_coords[i];
+        vertices[i].y = 0;
+        vertices[i].fixed = 0;
+        vertices[i].group = 0;
+        vertices[i].D = 0;
+        vertices[i].weight = 1;
+        vertices[i].weights = NULL;
+        vertices[i].edge_num = adj_offsets[i + 1] - adj_offsets[i];
+        vertices[i].conn = adj + adj_offsets[i];
+    }
+    for (int y = 0; y < row_count; y++) {
+        for (int i = row_offsets[y]; i < row_offsets[y + 1] && i < *vertex_count; i++) {
+            vertices[i].y = y;
+        }
+    }
+    adjacency = adj;
+}
@@ -0,0 +1,30 @@
+#ifndef BINARY_GRAPH_H
+#define BINARY_GRAPH_H
+#include <stdint.h>
+#include <stddef.h>
+
+#define BINARY_GRAPH_MAGIC "CSRB"
+#define BINARY_GRAPH_VERSION 1
+#define BINARY_GRAPH_ALIGN 64
+
+// Naglowek binarnego grafu wejsciowego (little-endian). Po nim, kazda wyrownana do 64 bajtow,
+// leza tablice int32: x wierzcholkow [vertex_count], offsety wierszy [row_count + 1],
+// offsety sasiadow CSR [vertex_count + 1] oraz sasiedzi CSR [entry_count].
+typedef struct binary_graph_header {
+    char magic[4];
+    uint32_t version;
+    uint32_t vertex_count;
+    uint32_t row_count;
+    uint32_t max_matrix;
+    uint32_t entry_count;
+    uint64_t x_offset;
+    uint64_t rows_offset;
+    uint64_t adj_offsets_offset;
+    uint64_t adjacency_offset;
+} BinaryGraphHeader;
+
+int is_binary_graph(const char *data, size_t size);
+void write_binary_graph(const char *filename, int vertex_count);
+void read_binary_graph(char *data, size_t size, int *vertex_count, int parts, double error_margin);
+
+#endif //BINARY_GRAPH_H
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "crypto/sha256.h"
+#include "graph_partition.h"
+#include "eigen_cache.h"
+
+char *eigen_cache_dir = NULL;
+
+// watki --all-graphs dziela rozne grafy - zrodlo jak vertices jest _Thread_local
+static _Thread_local uint8_t source_key[32];
+static _Thread_local int source_set = 0;
+
+void set_eigen_cache_source(const char *input_file, int graph_number) {
+    source_set = 0;
+    if (eigen_cache_dir == NULL || input_file == NULL || strcmp(input_file, "-") == 0) return;
+
+    char path[PATH_MAX];
+    if (realpath(input_file, path) == NULL) return;
+    char number[16];
+    sprintf(number, "\n%d", graph_number);
+
+    SHA256_CTX sha256;
+    sha256_init(&sha256);
+    sha256_update(&sha256, (const BYTE *)path, strlen(path));
+    sha256_update(&sha256, (const BYTE *)number, strlen(number));
+    sha256_final(&sha256, source_key);
+    source_set = 1;
+}
+
+void graph_hash(int vertex_count, uint8_t hash[32]) {
+    SHA256_CTX sha256;
+    sha256_init(&sha256);
+
+    uint32_t count = vertex_count;
+    sha256_update(&sha256, (const BYTE *)&count, sizeof(count));
+    for (int i = 0; i < vertex_count; i++) {
+        uint32_t edges = vertices[i].edge_num;
+        sha256_update(&sha256, (const BYTE *)&edges, sizeof(edges));
+        sha256_update(&sha256, (const BYTE *)vertices[i].conn, edges * sizeof(int));
+        if (vertices[i].weights) sha256_update(&sha256, (const BYTE *)vertices[i].weights, edges * sizeof(int));
+    }
+
+    sha256_final(&sha256, hash);
+}
+
+static char *cache_file_name(const uint8_t hash[32], const char *extension) {
+    char *name = malloc(strlen(eigen_cache_dir) + 2 + 64 + strlen(extension) + 1);
+    if (!name) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    int len = sprintf(name, "%s/", eigen_cache_dir);
+    for (int i = 0; i < 32; i++) len += sprintf(name + len, "%02x", hash[i]);
+    strcpy(name + len, extension);
+    return name;
+}
+
+static FILE *open_entry(const char *name, EigenCacheHeader *header) {
+    FILE *f = fopen(name, "rb");
+    if (!f) return NULL;
+    if (fread(header, sizeof(*header), 1, f) != 1 || memcmp(header->magic, EIGEN_CACHE_MAGIC, 4) != 0 ||
+        header->version != EIGEN_CACHE_VERSION) {
+        fclose(f);
+        return NULL;
+    }
+    return f;
+}
+
+// pierwsze k wektorow wpisu; przy innej liczbie wierzcholkow nadmiar jest obcinany, a brak uzupelniany zerami
+static int read_vectors(FILE *f, const EigenCacheHeader *header, int vertex_count, int k, double *X) {
+    int shared = (int)header->vertex_count < vertex_count ? (int)header->vertex_count : vertex_count;
+    for (int c = 0; c < k; c++) {
+        double *column = X + (size_t)c * vertex_count;
+        if (fseek(f, sizeof(*header) + (long)c * header->vertex_count * sizeof(double), SEEK_SET) != 0 ||
+            fread(column, sizeof(double), shared, f) != (size_t)shared) {
+            return 0;
+        }
+        for (int i = shared; i < vertex_count; i++) column[i] = 0;
+    }
+    return 1;
+}
+
+// brak dokladnego trafienia - najnowszy wpis z tego samego zrodla jako punkt startowy solvera
+static int load_similar(int vertex_count, int k, double *X) {
+    if (!source_set) return 0;
+
+    char *pointer = cache_file_name(source_key, ".src");
+    FILE *p = fopen(pointer, "rb");
+    free(pointer);
+    if (!p) return 0;
+    uint8_t hash[32];
+    int read_ok = fread(hash, sizeof(hash), 1, p) == 1;
+    fclose(p);
+    if (!read_ok) return 0;
+
+    char *name = cache_file_name(hash, ".eig");
+    EigenCacheHeader header;
+    FILE *f = open_entry(name, &header);
+    free(name);
+    if (!f) return 0;
+    // wektory innej wersji grafu o zupelnie innym rozmiarze nic nie wnosza
+    int found = 0;
+    if (memcmp(header.source, source_key, 32) == 0 && (int)header.k >= k &&
+        labs((long)header.vertex_count - vertex_count) <= vertex_count / 10) {
+        found = read_vectors(f, &header, vertex_count, k, X);
+    }
+    fclose(f);
+    return found;
+}
+
+// zapis do pliku tymczasowego i rename - rownolegle watki (--all-graphs) nie widza polowicznych plikow
+static void write_atomically(const char *name, const void *first, size_t first_size, const void *rest, size_t rest_size) {
+    char *temp = malloc(strlen(name) + 32);
+    if (!temp) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    sprintf(temp, "%s.%lx.tmp", name, (unsigned long)pthread_self());
+    FILE *f = fopen(temp, "wb");
+    // cache jest opcjonalny - brak prawa zapisu nie przerywa programu
+    if (f) {
+        int ok = fwrite(first, first_size, 1, f) == 1 && (rest_size == 0 || fwrite(rest, rest_size, 1, f) == 1);
+        ok = (fclose(f) == 0) && ok;
+        if (!ok || rename(temp, name) != 0) remove(temp);
+    }
+    free(temp);
+}
+
+int load_eigenvectors(int vertex_count, int k, double *X) {
+    if (eigen_cache_dir == NULL) return 0;
+
+    uint8_t hash[32];
+    graph_hash(vertex_count, hash);
+    char *name = cache_file_name(hash, ".eig");
+    EigenCacheHeader header;
+    FILE *f = open_entry(name, &header);
+    free(name);
+
+    if (f) {
+        int exact = memcmp(header.hash, hash, 32) == 0 && (int)header.vertex_count == vertex_count && (int)header.k >= k &&
+                    read_vectors(f, &header, vertex_count, k, X);
+        fclose(f);
+        if (exact) return 2;
+    }
+    return load_similar(vertex_count, k, X);
+}
+
+void save_eigenvectors(int vertex_count, int k, const double *X) {
+    if (eigen_cache_dir == NULL) return;
+
+    EigenCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, EIGEN_CACHE_MAGIC, 4);
+    header.version = EIGEN_CACHE_VERSION;
+    graph_hash(vertex_count, header.hash);
+    header.vertex_count = vertex_count;
+    header.k = k;
+
+    if (source_set) memcpy(header.source, source_key, 32);
+
+    // istniejacy wpis z wieksza liczba wektorow zostaje
+    char *name = cache_file_name(header.hash, ".eig");
+    EigenCacheHeader stored;
+    FILE *existing = open_entry(name, &stored);
+    int keep = 0;
+    if (existing) {
+        fclose(existing);
+        keep = memcmp(stored.hash, header.hash, 32) == 0 && memcmp(stored.source, header.source, 32) == 0 && (int)stored.k >= k;
+    }
+
+    mkdir(eigen_cache_dir, 0755);
+    if (!keep) write_atomically(name, &header, sizeof(header), X, (size_t)k * vertex_count * sizeof(double));
+    free(name);
+
+    // wskaznik zrodla na najnowsza wersje grafu
+    if (source_set) {
+        char *pointer = cache_file_name(source_key, ".src");
+        write_atomically(pointer, header.hash, sizeof(header.hash), NULL, 0);
+        free(pointer);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef EIGEN_CACHE_H
+#define EIGEN_CACHE_H
+#include <stdint.h>
+
+#define EIGEN_CACHE_MAGIC "CSRE"
+#define EIGEN_CACHE_VERSION 2
+
+// Plik <katalog>/<sha256 grafu>.eig: naglowek + k wektorow wlasnych po vertex_count liczb double.
+// Skrot liczony jest z wierszy CSR (liczba wierzcholkow, sasiedzi, wagi), wiec nie zalezy od nazwy pliku wejsciowego.
+// source - skrot sciezki pliku wejsciowego i numeru grafu; <katalog>/<source>.src zawiera skrot najnowszego wpisu
+// tego zrodla, wiec zmieniona wersja grafu dostaje punkt startowy bez przegladania katalogu.
+typedef struct eigen_cache_header {
+    char magic[4];
+    uint32_t version;
+    uint8_t hash[32];
+    uint8_t source[32];
+    uint32_t vertex_count;
+    uint32_t k;
+} EigenCacheHeader;
+
+// NULL - cache wylaczony (flaga --eigen-cache)
+extern char *eigen_cache_dir;
+
+void graph_hash(int vertex_count, uint8_t hash[32]);
+// zrodlo grafu w biezacym watku; "-" (stdin) - tylko dokladne trafienia
+void set_eigen_cache_source(const char *input_file, int graph_number);
+// 2 - wektory dla tego samego grafu, 1 - wektory poprzedniej wersji grafu z tego samego zrodla (tylko punkt
+// startowy), 0 - brak
+int load_eigenvectors(int vertex_count, int k, double *X);
+void save_eigenvectors(int vertex_count, int k, const double *X);
+
+#endif //EIGEN_CACHE_H
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <gsl/gsl_eigen.h>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+#include "spectral_method.h"
+#include "eigen_solver.h"
+
+// wektor staly jest wektorem wlasnym dla 0 - usuwamy jego skladowa (odjecie sredniej)
+static void deflate_constant(double *v, int n) {
+    double mean = 0;
+    for (int i = 0; i < n; i++) mean += v[i];
+    mean /= n;
+    for (int i = 0; i < n; i++) v[i] -= mean;
+}
+
+// Gram-Schmidt (dwukrotny) na kolumnach basis; kolumny liniowo zalezne sa usuwane, zwraca liczbe pozostalych
+static int orthonormalize(double *basis, int columns, int n) {
+    int kept = 0;
+    for (int j = 0; j < columns; j++) {
+        double *v = basis + (size_t)j * n;
+        double before = sqrt(vector_dot(v, v, n));
+        for (int repeat = 0; repeat < 2; repeat++) {
+            for (int i = 0; i < kept; i++) {
+                double *q = basis + (size_t)i * n;
+                double proj = vector_dot(q, v, n);
+                for (int t = 0; t < n; t++) v[t] -= proj * q[t];
+            }
+        }
+        double norm = sqrt(vector_dot(v, v, n));
+        if (norm <= 1e-10 * before || norm == 0) continue;
+        double *target = basis + (size_t)kept * n;
+        for (int t = 0; t < n; t++) target[t] = v[t] / norm;
+        kept++;
+    }
+    return kept;
+}
+
+// Rayleigh-Ritz: k najmniejszych par wlasnych macierzy G (m x m), wektory w C (m x k, kolumnami)
+static void small_eigen(const double *G, int m, int k, double *C, double *lambda) {
+    gsl_matrix *A = gsl_matrix_alloc(m, m);
+    gsl_matrix *V = gsl_matrix_alloc(m, m);
+    gsl_vector *eval = gsl_vector_alloc(m);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) gsl_matrix_set(A, i, j, 0.5 * (G[i * m + j] + G[j * m + i]));
+    }
+
+    gsl_eigen_symmv_workspace *workspace = gsl_eigen_symmv_alloc(m);
+    if (gsl_eigen_symmv(A, eval, V, workspace) != GSL_SUCCESS) {
+        printf("Blad podczas obliczania wartości i wektorów własnych.\n");
+        exit(19);
+    }
+    gsl_eigen_symmv_free(workspace);
+
+    int *used = calloc(m, sizeof(int));
+    if (!used) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    for (int c = 0; c < k; c++) {
+        int best = -1;
+        for (int i = 0; i < m; i++) {
+            if (!used[i] && (best == -1 || gsl_vector_get(eval, i) < gsl_vector_get(eval, best))) best = i;
+        }
+        used[best] = 1;
+        lambda[c] = gsl_vector_get(eval, best);
+        for (int i = 0; i < m; i++) C[c * m + i] = gsl_matrix_get(V, i, best);
+    }
+
+    free(used);
+    gsl_matrix_free(A);
+    gsl_matrix_free(V);
+    gsl_vector_free(eval);
+}
+
+int lobpcg_smallest(const SparseMatrix *L, int k, double *X, double *values, int warm_start, double tol, int max_iter) {
+    const int n = L->n;
+    const size_t block = (size_t)k * n;
+
+    double *S = malloc(3 * block * sizeof(double));
+    double *AS = malloc(3 * block * sizeof(double));
+    double *AX = malloc(block * sizeof(double));
+    double *P = malloc(block * sizeof(double));
+    double *next = malloc(2 * block * sizeof(double));
+    double *diag_inv = malloc(n * sizeof(double));
+    double *G = malloc(9 * k * k * sizeof(double));
+    double *C = malloc(3 * k * k * sizeof(double));
+    if (!S || !AS || !AX || !P || !next || !diag_inv || !G || !C) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    // norma ||L|| z kola Gerszgorina - tolerancja residuum jest wzgledna; przekatna jako prekondycjoner Jacobiego
+    double sigma = 0;
+    for (int i = 0; i < n; i++) {
+        double row = 0;
+        diag_inv[i] = 1;
+        for (int t = L->row_start[i]; t < L->row_start[i + 1]; t++) {
+            row += fabs(L->val[t]);
+            if (L->col[t] == i && L->val[t] > 0) diag_inv[i] = 1.0 / L->val[t];
+        }
+        if (row > sigma) sigma = row;
+    }
+    if (sigma == 0) sigma = 1;
+
+    if (!warm_start) {
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (size_t t = 0; t < block; t++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            X[t] = (double)(state >> 11) / 9007199254740992.0 - 0.5;
+        }
+    }
+    for (int j = 0; j < k; j++) deflate_constant(X + (size_t)j * n, n);
+    memcpy(S, X, block * sizeof(double));
+    if (orthonormalize(S, k, n) < k) {
+        // wektor startowy zdegenerowany (np. staly) - rozbijamy go indeksem wierzcholka
+        for (int j = 0; j < k; j++) {
+            for (int i = 0; i < n; i++) S[(size_t)j * n + i] = cos((j + 1) * 3.14159265358979 * (i + 0.5) / n);
+        }
+        orthonormalize(S, k, n);
+    }
+    memcpy(X, S, block * sizeof(double));
+    for (int j = 0; j < k; j++) matvec_mul(L, X + (size_t)j * n, AX + (size_t)j * n);
+
+    int has_p = 0;
+    int iter = 0;
+    for (; iter < max_iter; iter++) {
+        // residua R = AX - X * lambda, od razu prekondycjonowane do W (kolumny k..2k-1 bazy)
+        int converged = 1;
+        memcpy(S, X, block * sizeof(double));
+        for (int j = 0; j < k; j++) {
+            double *x = X + (size_t)j * n;
+            double *ax = AX + (size_t)j * n;
+            double *w = S + block + (size_t)j * n;
+            values[j] = vector_dot(x, ax, n);
+            double residual = 0;
+            for (int i = 0; i < n; i++) {
+                double r = ax[i] - values[j] * x[i];
+                residual += r * r;
+                w[i] = r * diag_inv[i];
+            }
+            if (sqrt(residual) > tol * sigma) converged = 0;
+            deflate_constant(w, n);
+        }
+        if (converged) break;
+
+        int columns = 2 * k;
+        if (has_p) {
+            memcpy(S + 2 * block, P, block * sizeof(double));
+            columns = 3 * k;
+        }
+        int m = orthonormalize(S, columns, n);
+
+        for (int j = 0; j < m; j++) {
+            if (j < k) memcpy(AS + (size_t)j * n, AX + (size_t)j * n, n * sizeof(double));
+            else matvec_mul(L, S + (size_t)j * n, AS + (size_t)j * n);
+        }
+        for (int a = 0; a < m; a++) {
+            for (int b = a; b < m; b++) {
+                G[a * m + b] = G[b * m + a] = vector_dot(S + (size_t)a * n, AS + (size_t)b * n, n);
+            }
+        }
+        small_eigen(G, m, k, C, values);
+
+        // X = S C, AX = AS C, P = czesc S C pochodzaca z kolumn W i P
+        for (int j = 0; j < k; j++) {
+            double *x = next + (size_t)j * n;
+            double *ax = next + block + (size_t)j * n;
+            double *p = P + (size_t)j * n;
+            memset(x, 0, n * sizeof(double));
+            memset(ax, 0, n * sizeof(double));
+            memset(p, 0, n * sizeof(double));
+            for (int a = 0; a < m; a++) {
+                double c = C[j * m + a];
+                const double *s = S + (size_t)a * n;
+                const double *as = AS + (size_t)a * n;
+                for (int i = 0; i < n; i++) {
+                    x[i] += c * s[i];
+                    ax[i] += c * as[i];
+                }
+                if (a >= k) {
+                    for (int i = 0; i < n; i++) p[i] += c * s[i];
+                }
+            }
+        }
+        memcpy(X, next, block * sizeof(double));
+        memcpy(AX, next + block, block * sizeof(double));
+        has_p = 1;
+    }
+
+    free(S);
+    free(AS);
+    free(AX);
+    free(P);
+    free(next);
+    free(diag_inv);
+    free(G);
+    free(C);
+    return iter;
+}
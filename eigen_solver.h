@@ -0,0 +1,10 @@
+#ifndef EIGEN_SOLVER_H
+#define EIGEN_SOLVER_H
+#include "spectral_method.h"
+
+#define LOBPCG_TOLERANCE 1e-4
+#define LOBPCG_MAX_ITER 1000
+
+int lobpcg_smallest(const SparseMatrix *L, int k, double *X, double *values, int warm_start, double tol, int max_iter);
+
+#endif //EIGEN_SOLVER_H
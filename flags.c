@@ -6,20 +6,26 @@
 #include <stdint.h>
 #include "flags.h"
 #include "graph_partition.h"
+#include "thread_pool.h"
+#include "eigen_cache.h"
+#include "incremental_partition.h"
+#include "kl_method.h"
 
 
-void flags_error(char **format, char *raw_parts, int *parts, char **method, char *raw_error_margin, double *error_margin, char *raw_choose_graph, int *choose_graph) {
-    if (*format == NULL || *method == NULL) {
+void flags_error(char **format, char *convert_file, char *raw_threads, char *raw_parts, int *parts, char **method, char *raw_error_margin, double *error_margin, char *raw_choose_graph, int *choose_graph, char *raw_restarts, char *raw_seed, char *raw_time_limit) {
+    if (convert_file == NULL && (*format == NULL || (*method == NULL && previous_file == NULL))) {
         printf("Blad: parametry wywolania sa niewystarczajace, aby uruchomic program.\n");
         exit(11);
     }
 
-    if (strcmp(*format, "ascii") != 0 && strcmp(*format, "binary") != 0) {
+    if (*format != NULL && strcmp(*format, "ascii") != 0 && strcmp(*format, "binary") != 0) {
         printf("Blad: Bledne dane wejsciowe. Niepoprawna wartosc flagi --format.\n");
         exit(14);
     }
 
-    if (strcmp(*method, "kl") != 0 && strcmp(*method, "m") != 0) {
+    if (*method != NULL && strcmp(*method, "kl") != 0 && strcmp(*method, "fm") != 0 && strcmp(*method, "m") != 0 && strcmp(*method, "ml") != 0 &&
+        strcmp(*method, "rcb") != 0 && strcmp(*method, "rib") != 0 && strcmp(*method, "sfc") != 0 &&
+        strcmp(*method, "lp") != 0 && strcmp(*method, "ldg") != 0 && strcmp(*method, "fennel") != 0) {
         printf("Blad: Bledne dane wejsciowe. Niepoprawna wartosc flagi --method.\n");
         exit(14);
     }
@@ -42,6 +48,15 @@ void flags_error(char **format, char *raw_parts, int *parts, char **method, char
         *error_margin = val;
     }
 
+    if (raw_threads != NULL) {
+        char *endptr;
+        thread_count = strtol(raw_threads, &endptr, 10);
+        if (*endptr != '\0' || thread_count < 1) {
+            printf("Blad: Bledne dane wejsciowe. Liczba watkow musi wynosic co najmniej 1.\n");
+            exit(14);
+        }
+    }
+
     if (raw_choose_graph != NULL) {
         char *endptr;
         *choose_graph = strtol(raw_choose_graph, &endptr, 10);
@@ -50,13 +65,44 @@ void flags_error(char **format, char *raw_parts, int *parts, char **method, char
             exit(14);
         }
     }
+
+    if (raw_restarts != NULL) {
+        char *endptr;
+        kl_restarts = strtol(raw_restarts, &endptr, 10);
+        if (*endptr != '\0' || kl_restarts < 1) {
+            printf("Blad: Bledne dane wejsciowe. Liczba startow (--restarts) musi wynosic co najmniej 1.\n");
+            exit(14);
+        }
+    }
+
+    if (raw_seed != NULL) {
+        char *endptr;
+        kl_seed = strtoull(raw_seed, &endptr, 10);
+        if (*endptr != '\0' || *raw_seed == '\0' || *raw_seed == '-') {
+            printf("Blad: Bledne dane wejsciowe. Niepoprawna wartosc flagi --seed.\n");
+            exit(14);
+        }
+    }
+
+    if (raw_time_limit != NULL) {
+        char *endptr;
+        kl_time_limit = strtod(raw_time_limit, &endptr);
+        if (*endptr != '\0' || !(kl_time_limit > 0)) {
+            printf("Blad: Bledne dane wejsciowe. Limit czasu (--time-limit) musi byc dodatnia liczba sekund.\n");
+            exit(14);
+        }
+    }
 }
 
-void flags(int argc, char *argv[], char **input_file, char **output_file, char **format, int *parts, char **method, double *error_margin, int *choose_graph) {
+void flags(int argc, char *argv[], char **input_file, char **output_file, char **format, int *parts, char **method, double *error_margin, int *choose_graph, char **convert_file, int *all_graphs) {
     int opt;
     char *raw_parts = NULL;
     char *raw_error_margin = NULL;
     char *raw_choose_graph = NULL;
+    char *raw_threads = NULL;
+    char *raw_restarts = NULL;
+    char *raw_seed = NULL;
+    char *raw_time_limit = NULL;
 
     static struct option long_options[] = {
         {"help", no_argument, 0, 'h'},
@@ -68,12 +114,25 @@ void flags(int argc, char *argv[], char **input_file, char **output_file, char *
         {"method", required_argument, 0, 'm'},
         {"error_margin", required_argument, 0, 'b'},
         {"graph_index", required_argument, 0, 'g'},
+        {"convert", required_argument, 0, 'c'},
+        {"all-graphs", no_argument, 0, 'a'},
+        {"wide", no_argument, 0, 'w'},
+        {"threads", required_argument, 0, 't'},
+        {"eigen-cache", required_argument, 0, 'e'},
+        {"previous", required_argument, 0, 'P'},
+        {"restarts", required_argument, 0, 'R'},
+        {"seed", required_argument, 0, 's'},
+        {"time-limit", required_argument, 0, 'T'},
         {0, 0, 0, 0}
     };
 
-    while ((opt = getopt_long(argc, argv, "fhm:i:o:r:b:p:g:", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "fhawm:i:o:r:b:p:g:c:t:e:P:R:s:T:", long_options, NULL)) != -1) {
         switch (opt) {
             case 'f': force_flag = 1; break;
+            case 'a': *all_graphs = 1; break;
+            case 'w': wide_flag = 1; break;
+            case 'e': eigen_cache_dir = optarg; break;
+            case 'P': previous_file = optarg; break;
             case 'h':
                 const char *help_text =
 "Program do podzialu grafu na grupy przy uzyciu metod Kernighan-Lin lub spektralnej.\n\n"
@@ -81,30 +140,66 @@ void flags(int argc, char *argv[], char **input_file, char **output_file, char *
 "Uzycie:\n"
 "  graph_partition [parametry]\n\n"
 "==============================  Parametry wymagane  ==================\n"
-"  -i, --input-file <plik>    Okresla plik wejsciowy zawierajacy dane grafu.\n"
+"  -i, --input-file <plik>    Okresla plik wejsciowy zawierajacy dane grafu (\"-\" - stdin dla metod ldg i fennel).\n"
 "  -o, --output-file <plik>   Okresla plik wyjsciowy do zapisu wynikow.\n"
 "  -r, --format <format>      Okresla format wyjsciowy (\"ascii\" lub \"binary\").\n"
-"  -m, --method <metoda>      Okresla metode podzialu (\"kl\" dla 2 grup lub \"m\" dla wiekszej liczby grup).\n\n"
+"  -m, --method <metoda>      Okresla metode podzialu (\"kl\", \"fm\", \"m\", \"ml\", \"rcb\", \"rib\", \"sfc\", \"lp\",\n"
+"                             \"ldg\" lub \"fennel\").\n\n"
 "==============================  Parametry opcjonalne  =================\n"
 "  -h, --help                 Wyswietla ta pomoc.\n"
 "  -f, --force                Wymusza podzial niezaleznie od marginesu bledu.\n"
 "  -p, --parts <liczba>       Liczba czesci (grup) do podzialu grafu (domyslnie 2).\n"
 "  -b, --error_margin <wartosc>   Margines bledu w procentach (domyslnie 10, 0 dla dokladnego podzialu).\n"
-"  -g, --graph_index <indeks>    Indeks grafu w pliku wejsciowym (jesli plik zawiera wiecej niz jeden graf).\n\n"
+"  -g, --graph_index <indeks>    Indeks grafu w pliku wejsciowym (jesli plik zawiera wiecej niz jeden graf).\n"
+"  -t, --threads <liczba>     Liczba watkow roboczych (domyslnie liczba rdzeni). Wynik nie zalezy od liczby watkow.\n"
+"  -w, --wide                 Tryb 32-bitowy: zdejmuje limit 1024 z 1 linii i zapisuje wynik binarny z polami uint32\n"
+"                             (flaga 0x02 w pierwszym bajcie). Grafy nie mieszczace sie w 16 bitach zapisywane sa tak zawsze.\n"
+"  -a, --all-graphs           Dzieli wszystkie grafy z pliku rownolegle, zapisujac wynik grafu N do <plik_wyjsciowy>_N.\n"
+"  -e, --eigen-cache <katalog>  Zapisuje wektory wlasne metody spektralnej w katalogu (klucz: skrot SHA-256 grafu).\n"
+"                             Ten sam graf nie jest liczony ponownie, a zmieniona wersja grafu z tego samego pliku\n"
+"                             startuje z wektorow poprzedniej.\n"
+"  -P, --previous <plik>      Podzial przyrostowy: startuje z wyniku poprzedniego uruchomienia (ASCII, binarny lub ldg/fennel,\n"
+"                             ta sama liczba --parts) i poprawia tylko brzeg w promieniu 2 krawedzi od wierzcholkow\n"
+"                             dodanych lub ze zmienionymi polaczeniami. Flaga --method nie jest wtedy wymagana.\n"
+"  -R, --restarts <liczba>    KL: liczba niezaleznych startow (BFS z losowego wierzcholka, losowy rozmiar z okna\n"
+"                             marginesu) na puli watkow zamiast przegladu rozmiarow; wygrywa najmniejsze ciecie.\n"
+"  -s, --seed <liczba>        Ziarno losowania startow --restarts (domyslnie 0). Wynik nie zalezy od liczby watkow.\n"
+"  -T, --time-limit <sekundy> KL: po uplywie limitu (liczonego od startu programu) przerywa obliczenia i zapisuje\n"
+"                             najlepszy znaleziony do tej pory podzial.\n"
+"  -c, --convert <plik>       Zapisuje wybrany graf z pliku .csrrg w binarnym formacie CSR i konczy dzialanie.\n"
+"                             Plik binarny mozna nastepnie podac jako --input-file (wczytywany przez mmap bez parsowania).\n\n"
 "==============================  Przyklady  ===========================\n"
 "  graph_partition --input-file graf.txt --output-file wynik.txt --format ascii --parts 2 --method kl --error_margin 10\n"
 "    Podzieli graf z pliku \"graf.txt\" na 2 grupy, uzywajac metody Kernighan-Lin, zapisujac wynik w formacie ASCII.\n\n"
 "  graph_partition --input-file graf.bin --output-file wynik.bin --format binary --parts 3 --method m --error_margin 5\n"
 "    Podzieli graf z pliku \"graf.bin\" na 3 grupy przy uzyciu metody spektralnej, zapisujac wynik w formacie binarnym.\n\n"
 "==============================  Opis metod  ===========================\n"
-"  kl       - Metoda Kernighan-Lin, stosowana do podzialu na 2 grupy. Optymalizuje ciecie krawedzi przez iteracyjne zamienianie wierzcholkow miedzy grupami.\n"
+"  kl       - Metoda Kernighan-Lin. Optymalizuje ciecie krawedzi przez iteracyjne zamienianie wierzcholkow miedzy grupami.\n"
+"             Dla wiecej niz 2 grup graf dzielony jest rekurencyjnie na pol (rownolegle w poddrzewach).\n"
+"  ml       - Metoda wielopoziomowa (dowolna liczba grup). Zgrubia graf dopasowaniami po najciezszych krawedziach,\n"
+"             dzieli najmniejszy graf metoda KL lub spektralna i rzutuje wynik w gore, poprawiajac brzeg na kazdym poziomie.\n"
+"  fm       - Metoda Fiduccia-Mattheyses (wiecej grup rekurencyjnie jak kl). Przenosi pojedyncze wierzcholki wybierane z kubelkow zyskow, przebieg kosztuje O(E).\n"
+"  rcb      - Rekurencyjna bisekcja po wspolrzednych (linie 2-3 pliku): ciecie wzdluz dluzszego boku obszaru,\n"
+"             punkt podzialu z selekcji O(n). Dla grafow siatkowych podzial w milisekundach.\n"
+"  rib      - Jak rcb, ale ciecie prostopadle do glownej osi bezwladnosci wierzcholkow.\n"
+"  sfc      - Krzywa Hilberta po wspolrzednych, pociete na rowne odcinki. Czas O(n) poza sortowaniem pozycyjnym,\n"
+"             bez przegladania krawedzi - dla bardzo duzych grafow albo jako szybki podzial wstepny.\n"
+"  lp       - Propagacja etykiet z limitem rozmiaru grup (liczniki atomowe), start z podzialu krzywa Hilberta.\n"
+"             Przebiegi po CSR na wielu watkach - dla grafow z milionami krawedzi. Przy wielu watkach wynik\n"
+"             moze zalezec od ich liczby (watki widza zmiany etykiet na biezaco).\n"
+"  ldg      - Podzial strumieniowy w jednym przebiegu (Linear Deterministic Greedy) dla grafow wiekszych niz pamiec:\n"
+"             linie 4 i 5 czytane sa na biezaco z pliku lub stdin, wierzcholek trafia do grupy z najwieksza liczba\n"
+"             znanych sasiadow przemnozona przez (1 - rozmiar / pojemnosc). W pamieci tylko wektor grup.\n"
+"             Wynik (\"-\" - stdout) to liczba wierzcholkow, liczba grup i linie \"wierzcholek;grupa\" w kolejnosci\n"
+"             przypisania (binarnie: flaga 0x04 i pary uint32). Bez poprawy ciecia i naprawy spojnosci grup.\n"
+"  fennel   - Jak ldg, ale z funkcja celu Fennel: liczba sasiadow minus kara rosnaca z rozmiarem grupy.\n"
 "  m        - Metoda spektralna, wykorzystuje wektor wlasny macierzy Laplacjana grafu do przypisania wierzcholkow do grup.\n\n"
 "==============================  Uwagi  ===============================\n"
-"  - Metoda KL wspiera jedynie podzial na 2 grupy. Jesli chcesz podzielic graf na wiecej niz 2 grupy, musisz wybrac metode m (spektralna).\n"
+"  - Metody KL i FM dziela graf na 2 grupy; wieksza liczbe grup uzyskuja przez rekurencyjna bisekcje\n"
+"    w proporcji floor(k/2) : ceil(k/2), wiec k nie musi byc potega dwojki.\n"
 "  - Flaga --force pozwala na wymuszenie podzialu grafu, nawet jesli margines bledu jest zbyt maly do dokladnego podzialu.\n"
 "  - Flaga --error_margin okresla dozwolona roznice w liczbie wierzcholkow w grupach, aby podzial byl uznany za poprawny.\n"
 "  - W przypadku pliku z wieloma grafami, nalezy podac odpowiedni indeks grafu za pomoca flagi --graph_index.\n"
-"  - Program wspiera tylko podzial na 2 grupy dla metody Kernighan-Lin, wiec przy innych liczbach czesci uzywana jest metoda spektralna.\n"
 "  - Domyslne wartosci:\n"
 "    - `-p` (liczba czesci) to 2.\n"
 "    - `-b` (margines bledu) to 10.\n\n"
@@ -127,9 +222,14 @@ void flags(int argc, char *argv[], char **input_file, char **output_file, char *
             case 'p': raw_parts = optarg; break;
             case 'b': raw_error_margin = optarg; break;
             case 'g': raw_choose_graph = optarg; break;
+            case 'c': *convert_file = optarg; break;
+            case 't': raw_threads = optarg; break;
+            case 'R': raw_restarts = optarg; break;
+            case 's': raw_seed = optarg; break;
+            case 'T': raw_time_limit = optarg; break;
             default: printf("Blad: Nieznany parametr.\n"); exit(12);
         }
     }
 
-    flags_error(format, raw_parts, parts, method, raw_error_margin, error_margin, raw_choose_graph, choose_graph);
+    flags_error(format, *convert_file, raw_threads, raw_parts, parts, method, raw_error_margin, error_margin, raw_choose_graph, choose_graph, raw_restarts, raw_seed, raw_time_limit);
 }
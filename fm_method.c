@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include "graph_partition.h"
+#include "fm_method.h"
+#include "graph_utils.h"
+
+static int vertex_gain(int v) {
+    int gain = 0;
+    for (int j = 0; j < vertices[v].edge_num; j++) {
+        int neighbor = vertices[v].conn[j];
+        if (neighbor == v) continue;
+        gain += (vertices[neighbor].group != vertices[v].group) ? edge_weight(&vertices[v], j) : -edge_weight(&vertices[v], j);
+    }
+    return gain;
+}
+
+static void bucket_insert(GainBuckets *b, int v) {
+    int side = vertices[v].group;
+    int slot = b->gain[v] + b->max_gain;
+    b->prev[v] = -1;
+    b->next[v] = b->head[side][slot];
+    if (b->next[v] != -1) b->prev[b->next[v]] = v;
+    b->head[side][slot] = v;
+    if (slot > b->top[side]) b->top[side] = slot;
+}
+
+static void bucket_remove(GainBuckets *b, int v) {
+    int side = vertices[v].group;
+    int slot = b->gain[v] + b->max_gain;
+    if (b->prev[v] != -1) b->next[b->prev[v]] = b->next[v];
+    else b->head[side][slot] = b->next[v];
+    if (b->next[v] != -1) b->prev[b->next[v]] = b->prev[v];
+}
+
+// najlepszy wierzcholek strony - wskaznik top schodzi tylko w dol, wiec wybor jest zamortyzowane O(1)
+static int bucket_best(GainBuckets *b, int side) {
+    while (b->top[side] >= 0 && b->head[side][b->top[side]] == -1) b->top[side]--;
+    return b->top[side] >= 0 ? b->head[side][b->top[side]] : -1;
+}
+
+int fiduccia_mattheyses(int vertex_count, int min_group, int max_group) {
+    // rozmiar grupy to suma wag jej wierzcholkow (na grafie wejsciowym - liczba wierzcholkow);
+    // dopuszczalny rozmiar grupy 0 tak, aby obie grupy miescily sie w [min_group, max_group]
+    int total = 0;
+    for (int i = 0; i < vertex_count; i++) total += vertices[i].weight;
+    int low = min_group > total - max_group ? min_group : total - max_group;
+    int high = max_group < total - min_group ? max_group : total - min_group;
+    int ideal = total / 2;
+
+    GainBuckets b;
+    b.max_gain = 0;
+    for (int i = 0; i < vertex_count; i++) {
+        int degree = 0;
+        for (int j = 0; j < vertices[i].edge_num; j++) degree += edge_weight(&vertices[i], j);
+        if (degree > b.max_gain) b.max_gain = degree;
+    }
+    int slots = 2 * b.max_gain + 1;
+    b.head[0] = malloc(slots * sizeof(int));
+    b.head[1] = malloc(slots * sizeof(int));
+    b.next = malloc(vertex_count * sizeof(int));
+    b.prev = malloc(vertex_count * sizeof(int));
+    b.gain = malloc(vertex_count * sizeof(int));
+    int *moves = malloc(vertex_count * sizeof(int));
+    if (!b.head[0] || !b.head[1] || !b.next || !b.prev || !b.gain || !moves) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    int size0 = 0;
+    for (int i = 0; i < vertex_count; i++) {
+        if (vertices[i].group == 0) size0 += vertices[i].weight;
+    }
+    int cut = cut_size(vertex_count);
+
+    while (1) {
+        for (int s = 0; s < slots; s++) b.head[0][s] = b.head[1][s] = -1;
+        b.top[0] = b.top[1] = -1;
+        for (int i = 0; i < vertex_count; i++) {
+            vertices[i].fixed = 0;
+            b.gain[i] = vertex_gain(i);
+            bucket_insert(&b, i);
+        }
+
+        int start_cut = cut, start_size0 = size0;
+        int best_cut = cut, best_moves = 0;
+        int best_imbalance = abs(size0 - ideal);
+        int move_count = 0;
+
+        while (move_count < vertex_count) {
+            int from0 = bucket_best(&b, 0);
+            int from1 = bucket_best(&b, 1);
+            if (from0 != -1 && size0 - vertices[from0].weight < low) from0 = -1;
+            if (from1 != -1 && size0 + vertices[from1].weight > high) from1 = -1;
+            if (from0 == -1 && from1 == -1) break;
+
+            int v;
+            if (from0 == -1) v = from1;
+            else if (from1 == -1) v = from0;
+            else if (b.gain[from0] != b.gain[from1]) v = b.gain[from0] > b.gain[from1] ? from0 : from1;
+            else v = size0 > ideal ? from0 : from1;
+
+            bucket_remove(&b, v);
+            vertices[v].fixed = 1;
+            cut -= b.gain[v];
+            size0 += vertices[v].group == 0 ? -vertices[v].weight : vertices[v].weight;
+            vertices[v].group = 1 - vertices[v].group;
+            moves[move_count++] = v;
+
+            // zmiana zysku dotyczy tylko sasiadow przeniesionego wierzcholka
+            for (int j = 0; j < vertices[v].edge_num; j++) {
+                int u = vertices[v].conn[j];
+                if (u == v || vertices[u].fixed) continue;
+                bucket_remove(&b, u);
+                int w = edge_weight(&vertices[v], j);
+                b.gain[u] += (vertices[u].group == vertices[v].group) ? -2 * w : 2 * w;
+                bucket_insert(&b, u);
+            }
+
+            int imbalance = abs(size0 - ideal);
+            if (cut < best_cut || (cut == best_cut && imbalance < best_imbalance)) {
+                best_cut = cut;
+                best_imbalance = imbalance;
+                best_moves = move_count;
+            }
+        }
+
+        // cofamy ruchy po najlepszym prefiksie
+        for (int m = move_count - 1; m >= best_moves; m--) {
+            int v = moves[m];
+            vertices[v].group = 1 - vertices[v].group;
+        }
+        cut = best_cut;
+        size0 = start_size0;
+        for (int m = 0; m < best_moves; m++) size0 += vertices[moves[m]].group == 1 ? -vertices[moves[m]].weight : vertices[moves[m]].weight;
+
+        if (best_moves == 0 || (cut == start_cut && abs(size0 - ideal) >= abs(start_size0 - ideal))) break;
+    }
+
+    for (int i = 0; i < vertex_count; i++) vertices[i].fixed = 0;
+
+    free(b.head[0]);
+    free(b.head[1]);
+    free(b.next);
+    free(b.prev);
+    free(b.gain);
+    free(moves);
+    return cut;
+}
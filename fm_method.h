@@ -0,0 +1,16 @@
+#ifndef FM_METHOD_H
+#define FM_METHOD_H
+
+typedef struct gain_buckets {
+    int max_gain;
+    int *head[2];
+    int top[2];
+    int *next;
+    int *prev;
+    int *gain;
+} GainBuckets;
+
+// min_group, max_group - granice sumy wag wierzcholkow kazdej z dwoch grup
+int fiduccia_mattheyses(int vertex_count, int min_group, int max_group);
+
+#endif //FM_METHOD_H
@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "graph_partition.h"
+#include "geometric_method.h"
+#include "graph_utils.h"
+#include "thread_pool.h"
+
+typedef struct geometric_task {
+    int *order;     // wierzcholki poddrzewa (rozlaczne fragmenty wspolnej tablicy)
+    double *keys;   // rzut wierzcholka order[i] na os ciecia
+    int count;
+    int parts;
+    int first_group;
+    int inertial;
+    Vertex *graph;
+} GeometricTask;
+
+static void geometric_task(int index, void *arg);
+
+static void swap_entries(int *order, double *keys, int a, int b) {
+    int o = order[a];
+    order[a] = order[b];
+    order[b] = o;
+    double k = keys[a];
+    keys[a] = keys[b];
+    keys[b] = k;
+}
+
+// quickselect z podzialem na trzy czesci (<, =, > pivot) - rowne wspolrzedne siatki nie psuja czasu liniowego
+static void select_kth(int *order, double *keys, int count, int k) {
+    int lo = 0, hi = count - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        double a = keys[lo], b = keys[mid], c = keys[hi];
+        double pivot = (a < b) ? ((b < c) ? b : (a < c ? c : a)) : ((a < c) ? a : (b < c ? c : b));
+
+        int lt = lo, i = lo, gt = hi;
+        while (i <= gt) {
+            if (keys[i] < pivot) swap_entries(order, keys, lt++, i++);
+            else if (keys[i] > pivot) swap_entries(order, keys, i, gt--);
+            else i++;
+        }
+        if (k < lt) hi = lt - 1;
+        else if (k > gt) lo = gt + 1;
+        else return;
+    }
+}
+
+// os ciecia: dluzszy bok prostokata otaczajacego albo wektor wlasny macierzy kowariancji 2x2 dla wiekszej wartosci
+static void cut_axis(const GeometricTask *task, double *ax, double *ay) {
+    const Vertex *g = task->graph;
+    if (!task->inertial) {
+        int min_x = g[task->order[0]].x, max_x = min_x, min_y = g[task->order[0]].y, max_y = min_y;
+        for (int i = 1; i < task->count; i++) {
+            const Vertex *v = &g[task->order[i]];
+            if (v->x < min_x) min_x = v->x;
+            if (v->x > max_x) max_x = v->x;
+            if (v->y < min_y) min_y = v->y;
+            if (v->y > max_y) max_y = v->y;
+        }
+        *ax = (max_x - min_x >= max_y - min_y) ? 1 : 0;
+        *ay = 1 - *ax;
+        return;
+    }
+
+    double mx = 0, my = 0;
+    for (int i = 0; i < task->count; i++) {
+        mx += g[task->order[i]].x;
+        my += g[task->order[i]].y;
+    }
+    mx /= task->count;
+    my /= task->count;
+    double sxx = 0, sxy = 0, syy = 0;
+    for (int i = 0; i < task->count; i++) {
+        double dx = g[task->order[i]].x - mx, dy = g[task->order[i]].y - my;
+        sxx += dx * dx;
+        sxy += dx * dy;
+        syy += dy * dy;
+    }
+    double lambda = 0.5 * (sxx + syy) + sqrt(0.25 * (sxx - syy) * (sxx - syy) + sxy * sxy);
+    if (fabs(sxy) > 1e-12) {
+        *ax = lambda - syy;
+        *ay = sxy;
+    } else {
+        *ax = (sxx >= syy) ? 1 : 0;
+        *ay = 1 - *ax;
+    }
+    double norm = sqrt(*ax * *ax + *ay * *ay);
+    *ax /= norm;
+    *ay /= norm;
+}
+
+static void bisect_geometric(GeometricTask *task) {
+    if (task->parts == 1 || task->count < 2) {
+        for (int i = 0; i < task->count; i++) task->graph[task->order[i]].group = task->first_group;
+        return;
+    }
+
+    double ax, ay;
+    cut_axis(task, &ax, &ay);
+    for (int i = 0; i < task->count; i++) {
+        const Vertex *v = &task->graph[task->order[i]];
+        // remis wspolrzednych rozstrzyga numer wierzcholka - wynik niezalezny od kolejnosci w tablicy
+        task->keys[i] = ax * v->x + ay * v->y + task->order[i] * 1e-9;
+    }
+
+    int left_parts = task->parts / 2;
+    int split = (int)((long)task->count * left_parts / task->parts);
+    select_kth(task->order, task->keys, task->count, split);
+
+    GeometricTask children[2];
+    for (int side = 0; side < 2; side++) {
+        children[side] = *task;
+        children[side].order = task->order + (side == 0 ? 0 : split);
+        children[side].keys = task->keys + (side == 0 ? 0 : split);
+        children[side].count = side == 0 ? split : task->count - split;
+        children[side].parts = side == 0 ? left_parts : task->parts - left_parts;
+        children[side].first_group = task->first_group + (side == 0 ? 0 : left_parts);
+    }
+
+    if (task->count >= GEOMETRIC_PARALLEL_MIN) {
+        parallel_for(2, geometric_task, children);
+    } else {
+        bisect_geometric(&children[0]);
+        bisect_geometric(&children[1]);
+    }
+}
+
+static void geometric_task(int index, void *arg) {
+    bisect_geometric((GeometricTask *)arg + index);
+}
+
+void coordinate_bisection(int parts, int vertex_count, double error_margin, int inertial) {
+    GeometricTask root;
+    root.order = malloc(vertex_count * sizeof(int));
+    root.keys = malloc(vertex_count * sizeof(double));
+    if (!root.order || !root.keys) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    for (int i = 0; i < vertex_count; i++) root.order[i] = i;
+    root.count = vertex_count;
+    root.parts = parts;
+    root.first_group = 0;
+    root.inertial = inertial;
+    // watki robocze maja wlasne (puste) vertices - zadania dostaja wskaznik do grafu jawnie
+    root.graph = vertices;
+    bisect_geometric(&root);
+
+    free(root.order);
+    free(root.keys);
+
+    int target = vertex_count / parts;
+    int margin = (error_margin < 0) ? 0 : (int)(target * error_margin / 100.0);
+    int max_size = target + margin;
+    if (max_size * parts < vertex_count) max_size = (vertex_count + parts - 1) / parts;
+    // geometryczny podzial jako punkt startowy dla poprawy brzegu (jak KL/FM, ale k-drogowo i tylko na brzegu)
+    refine_boundary_weighted(vertex_count, parts, target - margin, max_size);
+    fix_group_connectivity(vertex_count, parts, target - margin, max_size);
+}
+
+// numer punktu (x, y) na krzywej Hilberta rzedu order (siatka 2^order x 2^order)
+static uint64_t hilbert_key(uint32_t x, uint32_t y, int order) {
+    uint64_t key = 0;
+    for (uint32_t s = (uint32_t)1 << (order - 1); s > 0; s >>= 1) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        key += (uint64_t)s * s * ((3 * rx) ^ ry);
+        // obrot cwiartki, zeby krzywa byla ciagla
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            uint32_t t = x;
+            x = y;
+            y = t;
+        }
+        x &= s - 1;
+        y &= s - 1;
+    }
+    return key;
+}
+
+typedef struct curve_entry {
+    uint64_t key;
+    int vertex;
+} CurveEntry;
+
+typedef struct curve_job {
+    const Vertex *graph;
+    CurveEntry *entries;
+    int vertex_count;
+    int order;
+    int min_x;
+    int min_y;
+} CurveJob;
+
+static void curve_key_task(int block, void *arg) {
+    CurveJob *job = arg;
+    int last = (block + 1) * SFC_BLOCK < job->vertex_count ? (block + 1) * SFC_BLOCK : job->vertex_count;
+    for (int i = block * SFC_BLOCK; i < last; i++) {
+        job->entries[i].key = hilbert_key(job->graph[i].x - job->min_x, job->graph[i].y - job->min_y, job->order);
+        job->entries[i].vertex = i;
+    }
+}
+
+// LSD radix sort po 16 bitach; tylko tyle przebiegow, ile bitow ma najwiekszy klucz. Sortowanie stabilne,
+// wiec rowne klucze zostaja w kolejnosci numerow wierzcholkow.
+static void radix_sort_curve(CurveEntry *entries, CurveEntry *buffer, int count, int key_bits) {
+    size_t *histogram = malloc((1 << SFC_RADIX_BITS) * sizeof(size_t));
+    if (!histogram) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    for (int shift = 0; shift < key_bits; shift += SFC_RADIX_BITS) {
+        memset(histogram, 0, (1 << SFC_RADIX_BITS) * sizeof(size_t));
+        for (int i = 0; i < count; i++) histogram[(entries[i].key >> shift) & ((1 << SFC_RADIX_BITS) - 1)]++;
+        size_t sum = 0;
+        for (int d = 0; d < (1 << SFC_RADIX_BITS); d++) {
+            size_t c = histogram[d];
+            histogram[d] = sum;
+            sum += c;
+        }
+        for (int i = 0; i < count; i++) buffer[histogram[(entries[i].key >> shift) & ((1 << SFC_RADIX_BITS) - 1)]++] = entries[i];
+        memcpy(entries, buffer, count * sizeof(CurveEntry));
+    }
+    free(histogram);
+}
+
+void hilbert_order_groups(int parts, int vertex_count) {
+    CurveJob job;
+    job.graph = vertices;
+    job.vertex_count = vertex_count;
+    job.entries = malloc(vertex_count * sizeof(CurveEntry));
+    CurveEntry *buffer = malloc(vertex_count * sizeof(CurveEntry));
+    if (!job.entries || !buffer) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    int min_x = vertices[0].x, max_x = min_x, min_y = vertices[0].y, max_y = min_y;
+    for (int i = 1; i < vertex_count; i++) {
+        if (vertices[i].x < min_x) min_x = vertices[i].x;
+        if (vertices[i].x > max_x) max_x = vertices[i].x;
+        if (vertices[i].y < min_y) min_y = vertices[i].y;
+        if (vertices[i].y > max_y) max_y = vertices[i].y;
+    }
+    long extent = (max_x - min_x > max_y - min_y) ? max_x - min_x : max_y - min_y;
+    int order = 1;
+    while (order < 32 && (1L << order) <= extent) order++;
+    job.order = order;
+    job.min_x = min_x;
+    job.min_y = min_y;
+
+    parallel_for((vertex_count + SFC_BLOCK - 1) / SFC_BLOCK, curve_key_task, &job);
+    radix_sort_curve(job.entries, buffer, vertex_count, 2 * order);
+
+    // kolejne odcinki krzywej o rownej liczbie wierzcholkow
+    for (int p = 0; p < vertex_count; p++) {
+        vertices[job.entries[p].vertex].group = (int)((long)p * parts / vertex_count);
+    }
+    free(job.entries);
+    free(buffer);
+}
+
+void space_filling_curve_partition(int parts, int vertex_count, double error_margin) {
+    hilbert_order_groups(parts, vertex_count);
+
+    int target = vertex_count / parts;
+    int margin = (error_margin < 0) ? 0 : (int)(target * error_margin / 100.0);
+    int max_size = target + margin;
+    if (max_size * parts < vertex_count) max_size = (vertex_count + parts - 1) / parts;
+    fix_group_connectivity(vertex_count, parts, target - margin, max_size);
+}
@@ -0,0 +1,17 @@
+#ifndef GEOMETRIC_METHOD_H
+#define GEOMETRIC_METHOD_H
+
+#define GEOMETRIC_PARALLEL_MIN 4096   // mniejsze poddrzewa dzielone w biezacym watku
+#define SFC_BLOCK 65536               // wierzcholki na zadanie przy liczeniu kluczy Hilberta
+#define SFC_RADIX_BITS 16
+
+// Rekurencyjna bisekcja po wspolrzednych (x, y) wierzcholkow: "rcb" tnie wzdluz dluzszego boku prostokata
+// otaczajacego, "rib" (inertial) wzdluz glownej osi bezwladnosci. Podzial w proporcji floor(k/2) : ceil(k/2)
+// wyznacza selekcja k-tego elementu w O(n), bez sortowania.
+void coordinate_bisection(int parts, int vertex_count, double error_margin, int inertial);
+// Krzywa Hilberta po siatce (x, y): klucze sortowane pozycyjnie (radix), krzywa ciecia na parts rownych odcinkow.
+// Bez przechodzenia po krawedziach - tylko naprawa spojnosci grup na koncu.
+void hilbert_order_groups(int parts, int vertex_count);
+void space_filling_curve_partition(int parts, int vertex_count, double error_margin);
+
+#endif //GEOMETRIC_METHOD_H
@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "graph_partition.h"
+#include "graph_growing.h"
+#include "thread_pool.h"
+
+typedef struct growing_job {
+    const Vertex *graph;
+    int vertex_count;
+    int group1_size;
+    int **orders;   // kolejnosc dla kazdego startu
+    int *cuts;
+} GrowingJob;
+
+// BFS od start po calym grafie; skladowe nieosiagalne dochodza od najnizszego nieodwiedzonego numeru.
+// Zwraca ostatni wierzcholek skladowej startu (najdalszy), *depth - jego odleglosc.
+static int bfs_order(const Vertex *graph, int vertex_count, int start, int *order, int *dist, int *depth) {
+    for (int v = 0; v < vertex_count; v++) dist[v] = -1;
+    int head = 0, tail = 0, farthest = -1, next_root = 0;
+    dist[start] = 0;
+    order[tail++] = start;
+    while (head < vertex_count) {
+        if (head == tail) {
+            while (dist[next_root] >= 0) next_root++;
+            dist[next_root] = 0;
+            order[tail++] = next_root;
+        }
+        int v = order[head++];
+        for (int j = 0; j < graph[v].edge_num; j++) {
+            int neighbor = graph[v].conn[j];
+            if (dist[neighbor] >= 0) continue;
+            dist[neighbor] = dist[v] + 1;
+            order[tail++] = neighbor;
+        }
+        if (head == tail && farthest < 0) {
+            // koniec skladowej startu - ostatni wierzcholek BFS jest najdalszy
+            farthest = order[head - 1];
+            *depth = dist[farthest];
+        }
+    }
+    return farthest;
+}
+
+static void growing_task(int index, void *arg) {
+    GrowingJob *job = arg;
+    const Vertex *graph = job->graph;
+    int n = job->vertex_count;
+    int *order = job->orders[index];
+    int *dist = malloc(n * sizeof(int));
+    if (!dist) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    if (index == 0) {
+        // kolejnosc numerow (dawny podzial startowy) - dla siatek numerowanych wierszami bywa najlepsza
+        for (int p = 0; p < n; p++) order[p] = p;
+    } else {
+        // podwojny BFS: z najdalszego wierzcholka szukamy dalej, dopoki rosnie ekscentrycznosc
+        int seed = (int)((long)(index - 1) * n / GROWING_SEEDS);
+        int depth, best_depth = -1;
+        for (int round = 0; round < PERIPHERAL_ROUNDS; round++) {
+            int farthest = bfs_order(graph, n, seed, order, dist, &depth);
+            if (depth <= best_depth) break;
+            best_depth = depth;
+            seed = farthest;
+        }
+        bfs_order(graph, n, seed, order, dist, &depth);
+    }
+
+    // dist sluzy teraz jako pozycja w kolejnosci
+    for (int p = 0; p < n; p++) dist[order[p]] = p;
+    int cut = 0;
+    for (int p = 0; p < job->group1_size; p++) {
+        int v = order[p];
+        for (int j = 0; j < graph[v].edge_num; j++) {
+            if (dist[graph[v].conn[j]] >= job->group1_size) cut += edge_weight(&graph[v], j);
+        }
+    }
+    job->cuts[index] = cut;
+    free(dist);
+}
+
+void graph_growing_order(const Vertex *graph, int vertex_count, int group1_size, int *order) {
+    int seeds = 1 + (vertex_count < GROWING_SEEDS ? vertex_count : GROWING_SEEDS);
+    GrowingJob job;
+    job.graph = graph;
+    job.vertex_count = vertex_count;
+    job.group1_size = group1_size;
+    job.orders = malloc(seeds * sizeof(int *));
+    job.cuts = malloc(seeds * sizeof(int));
+    if (!job.orders || !job.cuts) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    job.orders[0] = order;
+    for (int s = 1; s < seeds; s++) {
+        job.orders[s] = malloc(vertex_count * sizeof(int));
+        if (!job.orders[s]) {
+            printf("Blad pamieci.\n");
+            exit(15);
+        }
+    }
+
+    parallel_for(seeds, growing_task, &job);
+
+    int best = 0;
+    for (int s = 1; s < seeds; s++) {
+        if (job.cuts[s] < job.cuts[best]) best = s;
+    }
+    if (best != 0) memcpy(order, job.orders[best], vertex_count * sizeof(int));
+    for (int s = 1; s < seeds; s++) free(job.orders[s]);
+    free(job.orders);
+    free(job.cuts);
+}
+
+void graph_growing_from(const Vertex *graph, int vertex_count, int start, int *order) {
+    int *dist = malloc(vertex_count * sizeof(int));
+    if (!dist) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    int depth;
+    bfs_order(graph, vertex_count, start, order, dist, &depth);
+    free(dist);
+}
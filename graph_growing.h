@@ -0,0 +1,17 @@
+#ifndef GRAPH_GROWING_H
+#define GRAPH_GROWING_H
+#include "graph_partition.h"
+
+#define GROWING_SEEDS 8        // liczba punktow startowych sprawdzanych rownolegle
+#define PERIPHERAL_ROUNDS 4    // maksymalna liczba powtorzen podwojnego BFS przy szukaniu wierzcholka peryferyjnego
+
+// Kolejnosc "rosniecia" grafu: BFS z wierzcholka pseudo-peryferyjnego (najdalszy od najdalszego, powtarzane dopoki
+// rosnie ekscentrycznosc). Dla GROWING_SEEDS startow rozlozonych po numerach wierzcholkow oraz dla zwyklej kolejnosci
+// numerow liczone jest ciecie po pierwszych group1_size wierzcholkach i wybierana jest kolejnosc z najmniejszym
+// cieciem (remis - wczesniejszy kandydat, wiec wynik nie zalezy od liczby watkow). Skladowe nieosiagniete z punktu
+// startowego dolaczane sa w kolejnosci numerow. graph podawany jawnie - funkcja moze byc wolana z watkow roboczych.
+void graph_growing_order(const Vertex *graph, int vertex_count, int group1_size, int *order);
+// kolejnosc BFS z podanego wierzcholka (bez szukania wierzcholka peryferyjnego) - starty losowe w KL
+void graph_growing_from(const Vertex *graph, int vertex_count, int start, int *order);
+
+#endif //GRAPH_GROWING_H
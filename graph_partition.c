@@ -4,26 +4,42 @@
 #include <getopt.h>
 #include <string.h>
 #include <stdint.h>
+#include <limits.h>
 #include "kl_method.h"
+#include "fm_method.h"
+#include "multilevel_method.h"
+#include "recursive_bisection.h"
+#include "geometric_method.h"
+#include "label_propagation.h"
+#include "stream_partition.h"
+#include "incremental_partition.h"
 #include "graph_partition.h"
 #include "spectral_method.h"
 #include "input_file.h"
 #include "flags.h"
 #include "output_file.h"
 #include "graph_utils.h"
+#include "binary_graph.h"
+#include "thread_pool.h"
+#include "eigen_cache.h"
 
-Vertex *vertices = NULL;
+_Thread_local Vertex *vertices = NULL;
+_Thread_local int *adjacency = NULL;
+int max_matrix = 0;
+int row_count = 0;
 int force_flag = 0;
+int wide_flag = 0;
 
 void graph_partioning(char *method, int parts, double error_margin, int vertex_count) {
-    if (strcmp(method, "kl") == 0) {
-        if (parts != 2) {
-            printf("Blad: Metoda KL wspiera tylko podzial na 2 grupy.");
-            exit(17);
-        }
-
+    if (previous_file != NULL) {
+        // zmiany grafu wzgledem poprzedniego wyniku poprawiane lokalnie zamiast podzialu od nowa
+        incremental_partitioning(previous_file, parts, vertex_count, error_margin);
+    } else if ((strcmp(method, "kl") == 0 || strcmp(method, "fm") == 0) && parts != 2) {
+        // metody dwudzielne - wiecej grup przez rekurencyjna bisekcje
+        recursive_bisection(method, parts, vertex_count, error_margin);
+    } else if (strcmp(method, "kl") == 0) {
         int ideal_half = vertex_count / 2;
-        int best_edge_cut = 999999;
+        int best_edge_cut = INT_MAX;
         int *best_groups = malloc(vertex_count * sizeof(int));
         if (!best_groups) {
             printf("Blad pamieci.");
@@ -34,25 +50,117 @@ void graph_partioning(char *method, int parts, double error_margin, int vertex_c
         int min_group = ideal_half - (int)(max_allowed_diff / 2);
         int max_group = ideal_half + (int)(max_allowed_diff / 2);
 
-        for (int size = min_group; size <= max_group; size++) {
-            reset_fixed_flags(vertex_count);
-            initial_bipartition(vertex_count, size);
-
-            int edge_cut = kernighan_lin_algorithm(size, vertex_count);
-            if (edge_cut < best_edge_cut) {
-                best_edge_cut = edge_cut;
-                for (int i = 0; i < vertex_count; i++) {
-                    best_groups[i] = vertices[i].group;
-                }
-            }
+        // kazdy rozmiar z okna marginesu to niezalezne uruchomienie KL - wykonywane rownolegle
+        best_edge_cut = kl_size_sweep(vertex_count, min_group, max_group, best_groups);
+        if (best_edge_cut != INT_MAX) {
+            for (int i = 0; i < vertex_count; i++) vertices[i].group = best_groups[i];
         }
 
         fix_group_connectivity(vertex_count, parts, min_group, max_group);
 
         free(best_groups);
+    } else if (strcmp(method, "fm") == 0) {
+        // pojedyncze ruchy FM same przesuwaja granice w oknie marginesu - jedno uruchomienie zamiast petli po rozmiarach
+        int ideal_half = vertex_count / 2;
+        double max_allowed_diff = (error_margin == -1) ? 0 : vertex_count * (error_margin / 100.0);
+        int min_group = ideal_half - (int)(max_allowed_diff / 2);
+        int max_group = ideal_half + (int)(max_allowed_diff / 2);
+
+        initial_bipartition(vertex_count, ideal_half);
+        fiduccia_mattheyses(vertex_count, min_group, max_group);
+
+        fix_group_connectivity(vertex_count, parts, min_group, max_group);
     } else if (strcmp(method, "m") == 0) {
         spectral_partitioning(parts, vertex_count, error_margin);
+    } else if (strcmp(method, "ml") == 0) {
+        multilevel_partitioning(parts, vertex_count, error_margin);
+    } else if (strcmp(method, "rcb") == 0 || strcmp(method, "rib") == 0) {
+        coordinate_bisection(parts, vertex_count, error_margin, strcmp(method, "rib") == 0);
+    } else if (strcmp(method, "sfc") == 0) {
+        space_filling_curve_partition(parts, vertex_count, error_margin);
+    } else if (strcmp(method, "lp") == 0) {
+        label_propagation(parts, vertex_count, error_margin);
+    }
+
+    // metody pilnuja granic tylko czesciowo - dociagamy grupy do [min, max] ruchami o najmniejszej stracie
+    if (!force_flag) {
+        int total_weight = 0;
+        for (int i = 0; i < vertex_count; i++) total_weight += vertices[i].weight;
+        int target = total_weight / parts;
+        int margin = (error_margin < 0) ? 0 : (int)(target * error_margin / 100.0);
+        int min_size = target - margin;
+        int max_size = target + margin;
+        if (max_size * parts < total_weight) max_size = (total_weight + parts - 1) / parts;
+        rebalance_groups(vertex_count, parts, min_size, max_size);
+    }
+}
+
+void write_output(const char *output_file, const char *format, int vertex_count) {
+    if(strcmp(format, "binary") == 0) {
+        write_binary_output(output_file, vertex_count);
+    } else if (strcmp(format, "ascii") == 0) {
+        write_ascii_output(output_file, vertex_count);
+    }
+}
+
+typedef struct all_graphs_job {
+    GraphSource *src;
+    char *input_file;
+    char *output_file;
+    char *format;
+    char *method;
+    int parts;
+    double error_margin;
+} AllGraphsJob;
+
+// wynik.txt -> wynik_3.txt (numeracja grafow jak w --graph_index)
+static char *graph_output_name(const char *output_file, int graph_number) {
+    size_t len = strlen(output_file);
+    char *name = malloc(len + 16);
+    if (!name) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    const char *slash = strrchr(output_file, '/');
+    const char *dot = strrchr(output_file, '.');
+    if (dot == NULL || (slash != NULL && dot < slash) || dot == output_file || (slash != NULL && dot == slash + 1)) {
+        sprintf(name, "%s_%d", output_file, graph_number);
+    } else {
+        sprintf(name, "%.*s_%d%s", (int)(dot - output_file), output_file, graph_number, dot);
     }
+    return name;
+}
+
+static void partition_graph_task(int index, void *arg) {
+    AllGraphsJob *job = arg;
+    int vertex_count = 0;
+
+    load_graph(job->src, index, &vertex_count, job->parts, job->error_margin);
+    set_eigen_cache_source(job->input_file, index + 1);
+    graph_partioning(job->method, job->parts, job->error_margin, vertex_count);
+    printf("Graf %d: nierownowaga grup %.2f%%\n", index + 1, partition_imbalance(vertex_count, job->parts));
+    remove_cross_group_connections(vertex_count, job->error_margin);
+
+    char *name = graph_output_name(job->output_file, index + 1);
+    write_output(name, job->format, vertex_count);
+    free(name);
+    free_graph();
+}
+
+void partition_all_graphs(char *input_file, char *output_file, char *format, char *method, int parts, double error_margin) {
+    GraphSource src;
+    open_graph_source(input_file, &src);
+    if (src.binary) {
+        printf("Blad: Flaga --all-graphs wymaga pliku .csrrg (plik binarny zawiera jeden graf).\n");
+        exit(14);
+    }
+
+    // linie 2-4 sa juz sparsowane raz - kazdy watek parsuje tylko swoja linie offsetow i buduje wlasny graf
+    AllGraphsJob job = { &src, input_file, output_file, format, method, parts, error_margin };
+    parallel_for(src.graph_count, partition_graph_task, &job);
+
+    close_graph_source(&src);
 }
 
 int main(int argc, char *argv[]) {
@@ -64,25 +172,42 @@ int main(int argc, char *argv[]) {
     double error_margin = 10.0;
     int vertex_count = 0;
     int choose_graph = 0;
+    char *convert_file = NULL;
+    int all_graphs = 0;
+
+    flags(argc, argv, &input_file, &output_file, &format, &parts, &method, &error_margin, &choose_graph, &convert_file, &all_graphs);
+    kl_start_clock();
+
+    if (convert_file == NULL && previous_file == NULL && (strcmp(method, "ldg") == 0 || strcmp(method, "fennel") == 0)) {
+        // tryb strumieniowy - graf nie jest wczytywany do pamieci
+        stream_partition(input_file, output_file, format, method, parts, error_margin, choose_graph);
+        return 0;
+    }
+
+    if (all_graphs && convert_file == NULL) {
+        partition_all_graphs(input_file, output_file, format, method, parts, error_margin);
+        printf("Podzial udany.");
+        return 0;
+    }
 
-    flags(argc, argv, &input_file, &output_file, &format, &parts, &method, &error_margin, &choose_graph);
     read_file(&input_file, &vertex_count, choose_graph, parts, error_margin);
+
+    if (convert_file != NULL) {
+        write_binary_graph(convert_file, vertex_count);
+        printf("Konwersja udana.");
+        free_graph();
+        return 0;
+    }
+    set_eigen_cache_source(input_file, choose_graph > 0 ? choose_graph : 1);
     graph_partioning(method, parts, error_margin, vertex_count);
+    if (method != NULL && strcmp(method, "kl") == 0 && kl_time_expired()) printf("Przekroczono limit czasu - zapisano najlepszy znaleziony podzial.\n");
+    printf("Nierownowaga grup: %.2f%%\n", partition_imbalance(vertex_count, parts));
 
     remove_cross_group_connections(vertex_count, error_margin);
 
-    if(strcmp(format, "binary") == 0) {
-        write_binary_output(output_file, vertex_count);
-    } else if (strcmp(format, "ascii") == 0) {
-        write_ascii_output(output_file, vertex_count);
-    }
+    write_output(output_file, format, vertex_count);
 
     printf("Podzial udany.");
-    for(int i=0; i < vertex_count; i++) {
-        if(vertices[i].conn != NULL) {
-            free(vertices[i].conn);
-        }
-    }
-    free(vertices);
+    free_graph();
     return 0;
 }
@@ -10,9 +10,24 @@ typedef struct vertex {
     int D;
     int x;
     int y;
+    int weight;     // waga wierzcholka (1 w grafie wejsciowym, suma scalonych w grafach zgrubnych)
+    int *weights;   // wagi krawedzi rownolegle do conn, NULL gdy wszystkie rowne 1
 } Vertex;
 
+static inline int edge_weight(const Vertex *v, int j) {
+    return v->weights ? v->weights[j] : 1;
+}
+
 extern int force_flag;
-extern Vertex *vertices;
+extern int wide_flag;
+// kazdy watek moze pracowac na wlasnym grafie (--all-graphs)
+extern _Thread_local Vertex *vertices;
+extern _Thread_local int *adjacency;
+extern int max_matrix;
+extern int row_count;
+
+void graph_partioning(char *method, int parts, double error_margin, int vertex_count);
+void write_output(const char *output_file, const char *format, int vertex_count);
+void partition_all_graphs(char *input_file, char *output_file, char *format, char *method, int parts, double error_margin);
 
 #endif //GRAPH_PARTITION_H
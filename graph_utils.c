@@ -1,21 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
+#include <limits.h>
+#include <string.h>
 #include "graph_partition.h"
 #include "graph_utils.h"
 
 void remove_cross_group_connections(int vertex_count, double error_margin) {
     for (int i = 0; i < vertex_count; i++) {
+        // filtrujemy w miejscu - wiersz CSR moze sie tylko skrocic
         int new_edge_num = 0;
-        int *new_conn = malloc(vertices[i].edge_num * sizeof(int));
-        if (!new_conn) {
-            printf("Blad pamieci.\n");
-            exit(15);
-        }
-
         for (int j = 0; j < vertices[i].edge_num; j++) {
             int neighbor = vertices[i].conn[j];
             if (vertices[neighbor].group == vertices[i].group) {
-                new_conn[new_edge_num++] = neighbor;
+                vertices[i].conn[new_edge_num++] = neighbor;
             }
         }
 
@@ -24,12 +22,21 @@ void remove_cross_group_connections(int vertex_count, double error_margin) {
             exit(16);
         }
 
-        free(vertices[i].conn);
-        vertices[i].conn = new_conn;
         vertices[i].edge_num = new_edge_num;
     }
 }
 
+int cut_size(int vertex_count) {
+    int cut = 0;
+    for (int i = 0; i < vertex_count; i++) {
+        for (int j = 0; j < vertices[i].edge_num; j++) {
+            int neighbor = vertices[i].conn[j];
+            if (neighbor > i && vertices[neighbor].group != vertices[i].group) cut += edge_weight(&vertices[i], j);
+        }
+    }
+    return cut;
+}
+
 int is_vertex_connected_to_own_group(int v) {
     for (int i = 0; i < vertices[v].edge_num; i++) {
         int neighbor = vertices[v].conn[i];
@@ -47,18 +54,187 @@ int has_connection_in_group(int v, int group) {
 }
 int find_swap_candidate(int from_group, int to_group, int vertex_count) {
     for (int i = 0; i < vertex_count; i++) {
-        if (vertices[i].group == to_group && !vertices[i].processed && is_vertex_connected_to_own_group(i)) {
+        // kandydat po przeniesieniu do from_group nadal musi miec tam sasiada
+        if (vertices[i].group == to_group && !vertices[i].processed && is_vertex_connected_to_own_group(i) &&
+            has_connection_in_group(i, from_group)) {
             return i;
         }
     }
     return -1;
 }
 
-void fix_group_connectivity(int vertex_count, int parts, int min_size, int max_size) {
-    for (int i = 0; i < vertex_count; i++) {
-        vertices[i].processed = 0;
+// Indeks brzegu: dla kazdego wierzcholka liczniki sasiadow w poszczegolnych grupach (co najwyzej edge_num
+// roznych grup, wiec pamiec O(E)) oraz listy kandydatow do zamiany kluczowane para (grupa wierzcholka, grupa sasiada).
+// Wierzcholek jest na liscie (t, f), gdy lezy w t, ma sasiada w t i w f oraz nie byl jeszcze przenoszony w tej rundzie.
+typedef struct group_count {
+    int group;
+    int count;
+    int prev;
+    int next;
+} GroupCount;
+
+typedef struct boundary_index {
+    int parts;
+    int *first;         // wiersz vertex -> pierwszy slot w slots
+    int *used;          // zajete sloty wierzcholka
+    int *own;           // liczba sasiadow we wlasnej grupie
+    GroupCount *slots;
+    int *owner;         // slot -> wierzcholek
+    int *heads;         // parts * parts list kandydatow
+} BoundaryIndex;
+
+static int bucket_of(const BoundaryIndex *b, int slot, int v) {
+    return vertices[v].group * b->parts + b->slots[slot].group;
+}
+
+static void link_slot(BoundaryIndex *b, int slot, int v) {
+    int bucket = bucket_of(b, slot, v);
+    b->slots[slot].prev = -1;
+    b->slots[slot].next = b->heads[bucket];
+    if (b->heads[bucket] != -1) b->slots[b->heads[bucket]].prev = slot;
+    b->heads[bucket] = slot;
+}
+
+static void unlink_slot(BoundaryIndex *b, int slot, int v) {
+    GroupCount *c = &b->slots[slot];
+    if (c->prev != -1) b->slots[c->prev].next = c->next;
+    else b->heads[bucket_of(b, slot, v)] = c->next;
+    if (c->next != -1) b->slots[c->next].prev = c->prev;
+    c->prev = c->next = -1;
+}
+
+static int is_active(const BoundaryIndex *b, int v) {
+    return b->own[v] > 0 && !vertices[v].processed;
+}
+
+static int is_linked(const BoundaryIndex *b, int slot, int v) {
+    return b->slots[slot].prev != -1 || b->heads[bucket_of(b, slot, v)] == slot;
+}
+
+// wszystkie sloty wierzcholka na listy lub z list - przy zmianie grupy, own albo processed
+static void set_linked(BoundaryIndex *b, int v, int linked) {
+    for (int s = b->first[v]; s < b->first[v] + b->used[v]; s++) {
+        GroupCount *c = &b->slots[s];
+        int should = linked && c->count > 0 && c->group != vertices[v].group;
+        int is = is_linked(b, s, v);
+        if (should && !is) link_slot(b, s, v);
+        else if (!should && is) unlink_slot(b, s, v);
+    }
+}
+
+static void change_count(BoundaryIndex *b, int v, int group, int delta) {
+    int slot = -1, free_slot = -1;
+    for (int s = b->first[v]; s < b->first[v] + b->used[v]; s++) {
+        if (b->slots[s].group == group) slot = s;
+        else if (b->slots[s].count == 0 && free_slot == -1) free_slot = s;
+    }
+    if (slot == -1) {
+        if (free_slot != -1) {
+            slot = free_slot;
+        } else {
+            slot = b->first[v] + b->used[v]++;
+        }
+        b->slots[slot].group = group;
+        b->slots[slot].count = 0;
+        b->slots[slot].prev = b->slots[slot].next = -1;
+    }
+
+    int before = b->slots[slot].count;
+    b->slots[slot].count += delta;
+    if (group == vertices[v].group) {
+        int was_active = is_active(b, v);
+        b->own[v] += delta;
+        if (was_active != is_active(b, v)) set_linked(b, v, !was_active);
+    } else if (is_active(b, v)) {
+        if (before == 0 && b->slots[slot].count > 0) link_slot(b, slot, v);
+        else if (before > 0 && b->slots[slot].count == 0) unlink_slot(b, slot, v);
+    }
+}
+
+static void build_boundary_index(BoundaryIndex *b, int vertex_count, int parts) {
+    b->parts = parts;
+    b->first = malloc((vertex_count + 1) * sizeof(int));
+    b->used = calloc(vertex_count, sizeof(int));
+    b->own = calloc(vertex_count, sizeof(int));
+    b->heads = malloc((size_t)parts * parts * sizeof(int));
+    if (!b->first || !b->used || !b->own || !b->heads) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    b->first[0] = 0;
+    for (int v = 0; v < vertex_count; v++) b->first[v + 1] = b->first[v] + vertices[v].edge_num;
+    b->slots = malloc(((size_t)b->first[vertex_count] + 1) * sizeof(GroupCount));
+    b->owner = malloc(((size_t)b->first[vertex_count] + 1) * sizeof(int));
+    if (!b->slots || !b->owner) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    for (size_t t = 0; t < (size_t)parts * parts; t++) b->heads[t] = -1;
+
+    // liczniki bez list, potem jednorazowe podpiecie aktywnych wierzcholkow
+    for (int v = 0; v < vertex_count; v++) {
+        for (int s = b->first[v]; s < b->first[v + 1]; s++) b->owner[s] = v;
+        for (int j = 0; j < vertices[v].edge_num; j++) {
+            int neighbor = vertices[v].conn[j];
+            if (neighbor == v) continue;
+            int group = vertices[neighbor].group;
+            int slot = -1;
+            for (int s = b->first[v]; s < b->first[v] + b->used[v]; s++) {
+                if (b->slots[s].group == group) slot = s;
+            }
+            if (slot == -1) {
+                slot = b->first[v] + b->used[v]++;
+                b->slots[slot] = (GroupCount){ group, 0, -1, -1 };
+            }
+            b->slots[slot].count++;
+            if (group == vertices[v].group) b->own[v]++;
+        }
+    }
+    for (int v = 0; v < vertex_count; v++) set_linked(b, v, is_active(b, v));
+}
+
+static void free_boundary_index(BoundaryIndex *b) {
+    free(b->first);
+    free(b->used);
+    free(b->own);
+    free(b->slots);
+    free(b->owner);
+    free(b->heads);
+}
+
+static void move_vertex(BoundaryIndex *b, int v, int target) {
+    int source = vertices[v].group;
+    set_linked(b, v, 0);
+    for (int j = 0; j < vertices[v].edge_num; j++) {
+        int neighbor = vertices[v].conn[j];
+        if (neighbor == v) continue;
+        change_count(b, neighbor, source, -1);
+        change_count(b, neighbor, target, 1);
+    }
+    vertices[v].group = target;
+    b->own[v] = 0;
+    for (int s = b->first[v]; s < b->first[v] + b->used[v]; s++) {
+        if (b->slots[s].group == target) b->own[v] = b->slots[s].count;
+    }
+    set_linked(b, v, is_active(b, v));
+}
+
+static void mark_processed(BoundaryIndex *b, int v) {
+    vertices[v].processed = 1;
+    set_linked(b, v, 0);
+}
+
+// najmniejszy numer grupy (innej niz wlasna) z sasiadem - kolejnosc jak w petli po grupach
+static int first_neighbor_group(const BoundaryIndex *b, int v, int after) {
+    int best = -1;
+    for (int s = b->first[v]; s < b->first[v] + b->used[v]; s++) {
+        const GroupCount *c = &b->slots[s];
+        if (c->count > 0 && c->group != vertices[v].group && c->group > after && (best == -1 || c->group < best)) best = c->group;
     }
+    return best;
+}
 
+void fix_group_connectivity(int vertex_count, int parts, int min_size, int max_size) {
     int *group_sizes = calloc(parts, sizeof(int));
     if (!group_sizes) {
         printf("Blad pamieci.\n");
@@ -67,47 +243,403 @@ void fix_group_connectivity(int vertex_count, int parts, int min_size, int max_s
 
     for (int i = 0; i < vertex_count; i++) group_sizes[vertices[i].group]++;
 
-    for (int i = 0; i < vertex_count; i++) {
-        if (!is_vertex_connected_to_own_group(i)) {
-            int current = vertices[i].group;
-            int best_target = -1;
+    for (int i = 0; i < vertex_count; i++) vertices[i].processed = 0;
+    BoundaryIndex index;
+    build_boundary_index(&index, vertex_count, parts);
 
-            for (int g = 0; g < parts; g++) {
-                if (g != current && has_connection_in_group(i, g)) {
-                    best_target = g;
-                    break;
+    // zamiana moze odciac sasiadow przenoszonych wierzcholkow, wiec powtarzamy az do braku zmian
+    for (int round = 0; round < FIX_ROUNDS; round++) {
+        int changed = 0;
+        if (round > 0) {
+            for (int i = 0; i < vertex_count; i++) {
+                if (vertices[i].processed) {
+                    vertices[i].processed = 0;
+                    set_linked(&index, i, is_active(&index, i));
                 }
             }
+        }
+
+        for (int i = 0; i < vertex_count; i++) {
+            if (index.own[i] == 0) {
+                int current = vertices[i].group;
+                int best_target = first_neighbor_group(&index, i, -1);
 
-            if (best_target != -1) {
-                // Jeśli miejsce w grupie jest, przenosimy wierzchołek
-                if (group_sizes[best_target] < max_size || force_flag) {
-                    vertices[i].group = best_target;
-                    vertices[i].processed = 1;
+                if (best_target != -1 && (group_sizes[best_target] < max_size || force_flag)) {
+                    // Jeśli miejsce w grupie jest, przenosimy wierzchołek
+                    move_vertex(&index, i, best_target);
+                    mark_processed(&index, i);
+                    changed = 1;
                     group_sizes[current]--;
                     group_sizes[best_target]++;
-                }
-            } else if (!force_flag) {
-                // Jeżeli brak miejsca, zamieniamy wierzchołki
-                for (int g = 0; g < parts; g++) {
-                    if (g != current && has_connection_in_group(i, g)) {
-                        int swap = find_swap_candidate(current, g, vertex_count);
-                        if (swap != -1) {
-                            // Wykonujemy zamianę
-                            int temp_group = vertices[swap].group;
-                            vertices[swap].group = current;
-                            vertices[i].group = g;
-                            vertices[swap].processed = 1;
-                            vertices[i].processed = 1;
-                            group_sizes[current]--;
-                            group_sizes[temp_group]++;
-                            group_sizes[g]++;
-                            break;
-                        }
+                } else if (best_target != -1) {
+                    // Jeżeli brak miejsca, zamieniamy wierzchołki (rozmiary grup sie nie zmieniaja);
+                    // kandydat to glowa listy (g, current) - lezy w g, ma tam sasiada i sasiada w current
+                    for (int g = best_target; g != -1; g = first_neighbor_group(&index, i, g)) {
+                        int slot = index.heads[g * parts + current];
+                        if (slot == -1) continue;
+                        int swap = index.owner[slot];
+                        move_vertex(&index, swap, current);
+                        move_vertex(&index, i, g);
+                        mark_processed(&index, swap);
+                        mark_processed(&index, i);
+                        changed = 1;
+                        break;
                     }
                 }
             }
         }
+        if (!changed) break;
     }
+    free_boundary_index(&index);
     free(group_sizes);
 }
+
+// k-drogowa poprawa brzegu: wierzcholek przechodzi do sasiedniej grupy o najwiekszym zysku, o ile pozwalaja wagi.
+// Pierwszy przebieg bierze wierzcholki z queue, kolejne tylko sasiadow przeniesionych - koszt przebiegu to
+// O(krawedzie brzegu). balance_ties = 0 wylacza ruchy o zerowym zysku (mniej przeniesien przy poprawie lokalnej).
+static void refine_from_queue(int vertex_count, int parts, int min_weight, int max_weight, int *queue, int queue_count, int balance_ties) {
+    int *part_weight = calloc(parts, sizeof(int));
+    int *link = calloc(parts, sizeof(int));
+    int *touched = malloc(parts * sizeof(int));
+    int *next_queue = malloc((vertex_count + 1) * sizeof(int));
+    int *queued = calloc(vertex_count, sizeof(int));
+    if (!part_weight || !link || !touched || !next_queue || !queued) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    for (int v = 0; v < vertex_count; v++) part_weight[vertices[v].group] += vertices[v].weight;
+
+    for (int pass = 0; pass < REFINE_PASSES && queue_count > 0; pass++) {
+        int moved = 0;
+        int next_count = 0;
+        for (int q = 0; q < queue_count; q++) {
+            int v = queue[q];
+            int from = vertices[v].group;
+            int touched_count = 0;
+            for (int j = 0; j < vertices[v].edge_num; j++) {
+                int g = vertices[vertices[v].conn[j]].group;
+                if (link[g] == 0 && g != from) touched[touched_count++] = g;
+                link[g] += edge_weight(&vertices[v], j);
+            }
+            // tylko wierzcholki brzegowe maja sasiada w innej grupie
+            if (touched_count == 0) {
+                link[from] = 0;
+                continue;
+            }
+
+            int w = vertices[v].weight;
+            int overweight = part_weight[from] > max_weight;
+            int best = -1, best_gain = INT_MIN;
+            for (int t = 0; t < touched_count; t++) {
+                int g = touched[t];
+                if (part_weight[g] + w > max_weight) continue;
+                if (!overweight && part_weight[from] - w < min_weight) continue;
+                int gain = link[g] - link[from];
+                if (gain > best_gain || (gain == best_gain && part_weight[g] < part_weight[best])) {
+                    best = g;
+                    best_gain = gain;
+                }
+            }
+
+            // przeniesienie zmniejsza ciecie, albo przy zerowym zysku wyrownuje wagi, albo odciaza zbyt ciezka grupe
+            if (best != -1 && (best_gain > 0 || overweight ||
+                               (balance_ties && best_gain == 0 && part_weight[best] + w < part_weight[from]))) {
+                vertices[v].group = best;
+                part_weight[from] -= w;
+                part_weight[best] += w;
+                moved++;
+
+                // zysk zmienil sie tylko dla v i jego sasiadow
+                if (queued[v] != pass + 1) {
+                    queued[v] = pass + 1;
+                    next_queue[next_count++] = v;
+                }
+                for (int j = 0; j < vertices[v].edge_num; j++) {
+                    int neighbor = vertices[v].conn[j];
+                    if (queued[neighbor] != pass + 1) {
+                        queued[neighbor] = pass + 1;
+                        next_queue[next_count++] = neighbor;
+                    }
+                }
+            }
+
+            link[from] = 0;
+            for (int t = 0; t < touched_count; t++) link[touched[t]] = 0;
+        }
+        if (moved == 0 || moved < queue_count * REFINE_CONVERGENCE) break;
+
+        int *swap = queue;
+        queue = next_queue;
+        next_queue = swap;
+        queue_count = next_count;
+    }
+
+    free(part_weight);
+    free(link);
+    free(touched);
+    free(queue);
+    free(next_queue);
+    free(queued);
+}
+
+void refine_boundary_weighted(int vertex_count, int parts, int min_weight, int max_weight) {
+    int *queue = malloc((vertex_count + 1) * sizeof(int));
+    if (!queue) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    int queue_count = 0;
+    for (int v = 0; v < vertex_count; v++) {
+        for (int j = 0; j < vertices[v].edge_num; j++) {
+            if (vertices[vertices[v].conn[j]].group != vertices[v].group) {
+                queue[queue_count++] = v;
+                break;
+            }
+        }
+    }
+    refine_from_queue(vertex_count, parts, min_weight, max_weight, queue, queue_count, 1);
+}
+
+void refine_boundary_region(int vertex_count, int parts, int min_weight, int max_weight, const int *region, int region_count) {
+    int *queue = malloc((vertex_count + 1) * sizeof(int));
+    if (!queue) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    memcpy(queue, region, region_count * sizeof(int));
+    refine_from_queue(vertex_count, parts, min_weight, max_weight, queue, region_count, 0);
+}
+
+typedef struct rebalance_move {
+    int gain;
+    int vertex;
+    int target;
+    int stamp;
+} RebalanceMove;
+
+typedef struct move_heap {
+    RebalanceMove *items;
+    int count;
+    int capacity;
+} MoveHeap;
+
+static int move_before(const RebalanceMove *a, const RebalanceMove *b) {
+    if (a->gain != b->gain) return a->gain > b->gain;
+    return a->vertex < b->vertex;
+}
+
+static void heap_push(MoveHeap *heap, RebalanceMove move) {
+    if (heap->count == heap->capacity) {
+        heap->capacity = heap->capacity ? heap->capacity * 2 : 1024;
+        heap->items = realloc(heap->items, heap->capacity * sizeof(RebalanceMove));
+        if (!heap->items) {
+            printf("Blad pamieci.\n");
+            exit(15);
+        }
+    }
+    int i = heap->count++;
+    while (i > 0 && move_before(&move, &heap->items[(i - 1) / 2])) {
+        heap->items[i] = heap->items[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap->items[i] = move;
+}
+
+static RebalanceMove heap_pop(MoveHeap *heap) {
+    RebalanceMove top = heap->items[0];
+    RebalanceMove last = heap->items[--heap->count];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= heap->count) break;
+        if (child + 1 < heap->count && move_before(&heap->items[child + 1], &heap->items[child])) child++;
+        if (!move_before(&heap->items[child], &last)) break;
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    if (heap->count > 0) heap->items[i] = last;
+    return top;
+}
+
+typedef struct rebalance_state {
+    int parts;
+    int min_size;
+    int max_size;
+    int *sizes;         // suma wag wierzcholkow w grupie
+    int *own;           // liczba sasiadow we wlasnej grupie
+    int *stamp;         // wersja wpisow wierzcholka w kopcu - starsze sa pomijane
+    int *locked;        // przeniesiony w tej rundzie
+    int *link;          // roboczo: waga krawedzi do grupy
+    int *touched;
+} RebalanceState;
+
+// przeniesienie z from do to zmniejsza naruszenie granic i nie tworzy nowego
+static int move_allowed(const RebalanceState *st, int from, int to, int weight) {
+    int from_over = st->sizes[from] > st->max_size;
+    int to_under = st->sizes[to] < st->min_size;
+    if (!from_over && !to_under) return 0;
+    if (!to_under && st->sizes[to] + weight > st->max_size) return 0;
+    if (!from_over && st->sizes[from] - weight < st->min_size) return 0;
+    return 1;
+}
+
+// najlepsze dozwolone przeniesienie wierzcholka z brzegu; nie moze odciac sasiada, dla ktorego v jest jedynym
+// polaczeniem we wlasnej grupie (remove_cross_group_connections wymaga, by kazdy mial sasiada w swojej grupie)
+static int best_move(RebalanceState *st, int v, RebalanceMove *move) {
+    int from = vertices[v].group;
+    int internal = 0, touched = 0;
+    for (int j = 0; j < vertices[v].edge_num; j++) {
+        int neighbor = vertices[v].conn[j];
+        if (neighbor == v) continue;
+        int g = vertices[neighbor].group;
+        if (g == from) {
+            internal += edge_weight(&vertices[v], j);
+            if (st->own[neighbor] == 1) touched = -1;
+            continue;
+        }
+        if (touched < 0) continue;
+        if (st->link[g] == 0) st->touched[touched++] = g;
+        st->link[g] += edge_weight(&vertices[v], j);
+    }
+    if (touched < 0) {
+        for (int j = 0; j < vertices[v].edge_num; j++) st->link[vertices[vertices[v].conn[j]].group] = 0;
+        return 0;
+    }
+
+    int found = 0;
+    for (int t = 0; t < touched; t++) {
+        int g = st->touched[t];
+        int gain = st->link[g] - internal;
+        if (move_allowed(st, from, g, vertices[v].weight) && (!found || gain > move->gain || (gain == move->gain && g < move->target))) {
+            move->gain = gain;
+            move->target = g;
+            found = 1;
+        }
+        st->link[g] = 0;
+    }
+    move->vertex = v;
+    move->stamp = st->stamp[v];
+    return found;
+}
+
+int rebalance_groups(int vertex_count, int parts, int min_size, int max_size) {
+    RebalanceState st;
+    st.parts = parts;
+    st.min_size = min_size;
+    st.max_size = max_size;
+    st.sizes = calloc(parts, sizeof(int));
+    st.own = calloc(vertex_count, sizeof(int));
+    st.stamp = calloc(vertex_count, sizeof(int));
+    st.locked = calloc(vertex_count, sizeof(int));
+    st.link = calloc(parts, sizeof(int));
+    st.touched = malloc(parts * sizeof(int));
+    if (!st.sizes || !st.own || !st.stamp || !st.locked || !st.link || !st.touched) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    for (int v = 0; v < vertex_count; v++) {
+        st.sizes[vertices[v].group] += vertices[v].weight;
+        for (int j = 0; j < vertices[v].edge_num; j++) {
+            int neighbor = vertices[v].conn[j];
+            if (neighbor != v && vertices[neighbor].group == vertices[v].group) st.own[v]++;
+        }
+    }
+
+    MoveHeap heap = { NULL, 0, 0 };
+    int total_moves = 0;
+    // kazda runda: kopiec najlepszych przeniesien z brzegu; po przeniesieniu odswiezamy wpisy sasiadow
+    for (int round = 0; round < FIX_ROUNDS; round++) {
+        int violated = 0;
+        for (int g = 0; g < parts; g++) {
+            if (st.sizes[g] > max_size || st.sizes[g] < min_size) violated = 1;
+        }
+        if (!violated) break;
+
+        heap.count = 0;
+        for (int v = 0; v < vertex_count; v++) {
+            st.locked[v] = 0;
+            RebalanceMove move;
+            if (best_move(&st, v, &move)) heap_push(&heap, move);
+        }
+
+        int moves = 0;
+        while (heap.count > 0) {
+            RebalanceMove move = heap_pop(&heap);
+            int v = move.vertex;
+            if (st.locked[v] || move.stamp != st.stamp[v]) continue;
+            // rozmiary grup zmienily sie od wstawienia - ruch liczymy od nowa
+            if (!move_allowed(&st, vertices[v].group, move.target, vertices[v].weight)) {
+                st.stamp[v]++;
+                if (best_move(&st, v, &move)) heap_push(&heap, move);
+                continue;
+            }
+
+            int from = vertices[v].group;
+            for (int j = 0; j < vertices[v].edge_num; j++) {
+                int neighbor = vertices[v].conn[j];
+                if (neighbor == v) continue;
+                if (vertices[neighbor].group == from) st.own[neighbor]--;
+                if (vertices[neighbor].group == move.target) st.own[neighbor]++;
+            }
+            vertices[v].group = move.target;
+            st.own[v] = 0;
+            for (int j = 0; j < vertices[v].edge_num; j++) {
+                int neighbor = vertices[v].conn[j];
+                if (neighbor != v && vertices[neighbor].group == move.target) st.own[v]++;
+            }
+            st.sizes[from] -= vertices[v].weight;
+            st.sizes[move.target] += vertices[v].weight;
+            st.locked[v] = 1;
+            moves++;
+
+            for (int j = 0; j < vertices[v].edge_num; j++) {
+                int neighbor = vertices[v].conn[j];
+                if (st.locked[neighbor]) continue;
+                st.stamp[neighbor]++;
+                RebalanceMove next;
+                if (best_move(&st, neighbor, &next)) heap_push(&heap, next);
+            }
+
+            int violated_now = 0;
+            for (int g = 0; g < parts; g++) {
+                if (st.sizes[g] > max_size || st.sizes[g] < min_size) violated_now = 1;
+            }
+            if (!violated_now) break;
+        }
+        total_moves += moves;
+        if (moves == 0) break;
+    }
+
+    free(heap.items);
+    free(st.sizes);
+    free(st.own);
+    free(st.stamp);
+    free(st.locked);
+    free(st.link);
+    free(st.touched);
+    return total_moves;
+}
+
+// najwieksze odchylenie rozmiaru grupy (suma wag) od idealnego, w procentach
+double partition_imbalance(int vertex_count, int parts) {
+    long *sizes = calloc(parts, sizeof(long));
+    if (!sizes) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    long total = 0;
+    for (int v = 0; v < vertex_count; v++) {
+        sizes[vertices[v].group] += vertices[v].weight;
+        total += vertices[v].weight;
+    }
+
+    double ideal = (double)total / parts;
+    double worst = 0;
+    for (int g = 0; g < parts; g++) {
+        double deviation = fabs(sizes[g] - ideal) / ideal * 100.0;
+        if (deviation > worst) worst = deviation;
+    }
+    free(sizes);
+    return worst;
+}
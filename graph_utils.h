@@ -1,10 +1,20 @@
 #ifndef GRAPH_UTILS_H
 #define GRAPH_UTILS_H
 
+#define FIX_ROUNDS 8
+#define REFINE_PASSES 8
+#define REFINE_CONVERGENCE 0.001   // koniec poprawy, gdy przebieg przeniosl mniej niz ten ulamek wierzcholkow brzegu
+
 void remove_cross_group_connections(int vertex_count, double error_margin);
+int cut_size(int vertex_count);
 int is_vertex_connected_to_own_group(int v);
 int has_connection_in_group(int v, int group);
 int find_swap_candidate(int from_group, int to_group, int vertex_count);
 void fix_group_connectivity(int vertex_count, int parts, int min_size, int max_size);
+void refine_boundary_weighted(int vertex_count, int parts, int min_weight, int max_weight);
+// jak refine_boundary_weighted, ale start tylko z wierzcholkow region i bez ruchow o zerowym zysku
+void refine_boundary_region(int vertex_count, int parts, int min_weight, int max_weight, const int *region, int region_count);
+int rebalance_groups(int vertex_count, int parts, int min_size, int max_size);
+double partition_imbalance(int vertex_count, int parts);
 
 #endif //GRAPH_UTILS_H
@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "graph_partition.h"
+#include "graph_utils.h"
+#include "output_file.h"
+#include "incremental_partition.h"
+
+char *previous_file = NULL;
+
+static void previous_error(void) {
+    printf("Blad: Niepoprawny format pliku --previous.\n");
+    exit(13);
+}
+
+static void *checked_malloc(size_t bytes) {
+    void *p = malloc(bytes ? bytes : 1);
+    if (!p) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    return p;
+}
+
+static char *read_whole_file(const char *filename, size_t *size) {
+    FILE *f = fopen(filename, "rb");
+    if (!f) {
+        printf("Blad: bledne dane wejsciowe.\n");
+        exit(14);
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len <= 0) previous_error();
+    char *data = checked_malloc(len + 1);
+    if (fread(data, 1, len, f) != (size_t)len) previous_error();
+    data[len] = '\0';
+    fclose(f);
+    *size = len;
+    return data;
+}
+
+static uint32_t read_le(const uint8_t *p, int bytes) {
+    uint32_t val = 0;
+    for (int b = bytes - 1; b >= 0; b--) val = (val << 8) | p[b];
+    return val;
+}
+
+static void check_group(const PreviousPartition *prev, int v, int g) {
+    if (v < 0 || v >= prev->vertex_count || g < 0 || g >= prev->parts) previous_error();
+}
+
+static void load_binary(const char *filename, const uint8_t *data, size_t size, PreviousPartition *prev) {
+    uint8_t flags_byte = data[0];
+    if (flags_byte & OUTPUT_FLAG_STREAM) {
+        if (size < 9) previous_error();
+        prev->vertex_count = (int)read_le(data + 1, 4);
+        prev->parts = (int)read_le(data + 5, 4);
+        if (prev->vertex_count <= 0 || prev->parts <= 0 || size != 9 + (size_t)prev->vertex_count * 8) previous_error();
+        prev->group = checked_malloc(prev->vertex_count * sizeof(int));
+        for (int i = 0; i < prev->vertex_count; i++) prev->group[i] = -1;
+        for (int i = 0; i < prev->vertex_count; i++) {
+            int v = (int)read_le(data + 9 + (size_t)i * 8, 4);
+            int g = (int)read_le(data + 13 + (size_t)i * 8, 4);
+            check_group(prev, v, g);
+            prev->group[v] = g;
+        }
+        return;
+    }
+
+    if (!validate_checksum(filename)) {
+        printf("Blad: Niepoprawna suma kontrolna pliku --previous.\n");
+        exit(13);
+    }
+    int field = (flags_byte & OUTPUT_FLAG_WIDE_IDS) ? 4 : 2;
+
+    // rekordy nie maja stalej dlugosci - pierwszy przebieg liczy wierzcholki i sasiadow, drugi je zapisuje
+    int count = 0;
+    size_t edges = 0;
+    size_t pos = 9;
+    while (pos < size) {
+        if (pos + 4 * (size_t)field > size) previous_error();
+        uint32_t edge_num = read_le(data + pos + 3 * field, field);
+        pos += (4 + (size_t)edge_num) * field;
+        edges += edge_num;
+        count++;
+    }
+    if (pos != size || count == 0) previous_error();
+
+    prev->vertex_count = count;
+    prev->parts = 0;
+    prev->group = checked_malloc(count * sizeof(int));
+    prev->row = checked_malloc((count + 1) * sizeof(int));
+    prev->adj = checked_malloc(edges * sizeof(int));
+    pos = 9;
+    prev->row[0] = 0;
+    for (int i = 0; i < count; i++) {
+        prev->group[i] = (int)read_le(data + pos + 2 * field, field);
+        int edge_num = (int)read_le(data + pos + 3 * field, field);
+        pos += 4 * (size_t)field;
+        for (int j = 0; j < edge_num; j++, pos += field) prev->adj[prev->row[i] + j] = (int)read_le(data + pos, field);
+        prev->row[i + 1] = prev->row[i] + edge_num;
+        if (prev->group[i] + 1 > prev->parts) prev->parts = prev->group[i] + 1;
+    }
+}
+
+static int next_field(char **p, long *val) {
+    while (**p == ' ' || **p == ';' || **p == '\r') (*p)++;
+    if (**p == '\n' || **p == '\0') return 0;
+    char *end;
+    *val = strtol(*p, &end, 10);
+    if (end == *p) previous_error();
+    *p = end;
+    return 1;
+}
+
+static void skip_to_next_line(char **p) {
+    while (**p != '\n' && **p != '\0') (*p)++;
+    if (**p == '\n') (*p)++;
+}
+
+// ASCII: "liczba wierzcholkow", "liczba grup", potem "x;y;grupa;liczba;sasiedzi..." albo "wierzcholek;grupa" (ldg/fennel)
+static void load_ascii(char *data, PreviousPartition *prev) {
+    char *p = data;
+    long val;
+    if (!next_field(&p, &val) || val <= 0) previous_error();
+    prev->vertex_count = (int)val;
+    skip_to_next_line(&p);
+    if (!next_field(&p, &val) || val <= 0) previous_error();
+    prev->parts = (int)val;
+    skip_to_next_line(&p);
+
+    prev->group = checked_malloc(prev->vertex_count * sizeof(int));
+    for (int i = 0; i < prev->vertex_count; i++) prev->group[i] = -1;
+    long fields[4];
+    size_t adj_capacity = 1024, adj_count = 0;
+    for (int i = 0; i < prev->vertex_count; i++) {
+        int field_count = 0;
+        while (field_count < 4 && next_field(&p, &fields[field_count])) field_count++;
+
+        if (field_count == 2) {
+            if (prev->row) previous_error();
+            check_group(prev, (int)fields[0], (int)fields[1]);
+            prev->group[fields[0]] = (int)fields[1];
+        } else if (field_count == 4) {
+            if (i == 0) {
+                prev->row = checked_malloc((prev->vertex_count + 1) * sizeof(int));
+                prev->adj = checked_malloc(adj_capacity * sizeof(int));
+                prev->row[0] = 0;
+            }
+            if (!prev->row) previous_error();
+            check_group(prev, i, (int)fields[2]);
+            prev->group[i] = (int)fields[2];
+            long neighbor;
+            for (long j = 0; j < fields[3]; j++) {
+                if (!next_field(&p, &neighbor)) previous_error();
+                if (adj_count == adj_capacity) {
+                    adj_capacity *= 2;
+                    prev->adj = realloc(prev->adj, adj_capacity * sizeof(int));
+                    if (!prev->adj) {
+                        printf("Blad pamieci.\n");
+                        exit(15);
+                    }
+                }
+                prev->adj[adj_count++] = (int)neighbor;
+            }
+            prev->row[i + 1] = (int)adj_count;
+        } else {
+            previous_error();
+        }
+        skip_to_next_line(&p);
+    }
+}
+
+void load_previous_partition(const char *filename, PreviousPartition *prev) {
+    memset(prev, 0, sizeof(*prev));
+    size_t size;
+    char *data = read_whole_file(filename, &size);
+    // wynik ASCII zaczyna sie od liczby, binarny od bajtu flag
+    if ((unsigned)(data[0] - '0') <= 9) load_ascii(data, prev);
+    else if (data[0] & OUTPUT_FLAG_LITTLE_ENDIAN) load_binary(filename, (const uint8_t *)data, size, prev);
+    else previous_error();
+    free(data);
+    for (int i = 0; i < prev->vertex_count; i++) {
+        if (prev->group[i] < 0) previous_error();
+    }
+}
+
+void free_previous_partition(PreviousPartition *prev) {
+    free(prev->group);
+    free(prev->row);
+    free(prev->adj);
+    memset(prev, 0, sizeof(*prev));
+}
+
+// czy sasiedzi v z tej samej (starej) grupy zgadzaja sie z lista zapisana w poprzednim wyniku
+static int same_neighbors(const PreviousPartition *prev, int v, int *mark) {
+    int saved = prev->row[v + 1] - prev->row[v];
+    for (int j = prev->row[v]; j < prev->row[v + 1]; j++) {
+        int neighbor = prev->adj[j];
+        if (neighbor < 0 || neighbor >= prev->vertex_count) return 0;
+        mark[neighbor] = v + 1;
+    }
+    int current = 0;
+    for (int j = 0; j < vertices[v].edge_num; j++) {
+        int neighbor = vertices[v].conn[j];
+        if (neighbor >= prev->vertex_count) return 0;
+        if (prev->group[neighbor] != prev->group[v]) continue;
+        if (mark[neighbor] != v + 1) return 0;
+        current++;
+    }
+    return current == saved;
+}
+
+void incremental_partitioning(const char *filename, int parts, int vertex_count, double error_margin) {
+    PreviousPartition prev;
+    load_previous_partition(filename, &prev);
+    if (prev.parts != parts) {
+        printf("Blad: Plik --previous zawiera %d grup, a --parts wynosi %d.\n", prev.parts, parts);
+        exit(14);
+    }
+
+    int *mark = calloc(prev.vertex_count > vertex_count ? prev.vertex_count : vertex_count, sizeof(int));
+    int *queue = checked_malloc(vertex_count * sizeof(int));
+    int *hops = checked_malloc(vertex_count * sizeof(int));
+    int *link = calloc(parts, sizeof(int));
+    if (!mark || !link) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    // zmienione wierzcholki trafiaja na poczatek kolejki z odlegloscia 0
+    int changed = 0;
+    for (int v = 0; v < vertex_count; v++) {
+        hops[v] = -1;
+        if (v < prev.vertex_count) {
+            vertices[v].group = prev.group[v];
+            if (prev.row && !same_neighbors(&prev, v, mark)) {
+                hops[v] = 0;
+                queue[changed++] = v;
+            }
+        } else {
+            vertices[v].group = -1;
+            hops[v] = 0;
+            queue[changed++] = v;
+        }
+    }
+
+    // nowe wierzcholki (numery ponad poprzedni wynik) - grupa wiekszosci przypisanych sasiadow, w kolejnosci BFS od
+    // nowych wierzcholkow z przypisanym sasiadem; kazdy trafia do kolejki raz, wiec czas zalezy tylko od liczby nowych
+    int first_new = prev.vertex_count < vertex_count ? prev.vertex_count : vertex_count;
+    int new_count = vertex_count - first_new;
+    int *pending = checked_malloc(new_count * sizeof(int));
+    char *queued = calloc(new_count ? new_count : 1, 1);   // indeks: numer wierzcholka - first_new
+    if (!queued) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    int head = 0, tail = 0;
+    for (int v = first_new; v < vertex_count; v++) {
+        for (int j = 0; j < vertices[v].edge_num; j++) {
+            if (vertices[vertices[v].conn[j]].group >= 0) {
+                queued[v - first_new] = 1;
+                pending[tail++] = v;
+                break;
+            }
+        }
+    }
+    int next_root = first_new;
+    while (1) {
+        while (head < tail) {
+            int v = pending[head++];
+            int best = -1;
+            for (int j = 0; j < vertices[v].edge_num; j++) {
+                int g = vertices[vertices[v].conn[j]].group;
+                if (g < 0) continue;
+                link[g]++;
+                if (best < 0 || link[g] > link[best]) best = g;
+            }
+            for (int j = 0; j < vertices[v].edge_num; j++) {
+                int g = vertices[vertices[v].conn[j]].group;
+                if (g >= 0) link[g] = 0;
+            }
+            vertices[v].group = best >= 0 ? best : 0;
+            // nieprzypisani sasiedzi sa zawsze nowymi wierzcholkami
+            for (int j = 0; j < vertices[v].edge_num; j++) {
+                int neighbor = vertices[v].conn[j];
+                if (vertices[neighbor].group >= 0 || queued[neighbor - first_new]) continue;
+                queued[neighbor - first_new] = 1;
+                pending[tail++] = neighbor;
+            }
+        }
+        // skladowa bez zadnego przypisanego wierzcholka - start w grupie 0, wyrowna ja rebalance
+        while (next_root < vertex_count && queued[next_root - first_new]) next_root++;
+        if (next_root == vertex_count) break;
+        queued[next_root - first_new] = 1;
+        pending[tail++] = next_root;
+    }
+    free(pending);
+    free(queued);
+
+    // obszar poprawy: BFS do INCREMENTAL_HOPS krawedzi od zmienionych wierzcholkow
+    int region = changed;
+    for (int q = 0; q < region; q++) {
+        int v = queue[q];
+        if (hops[v] == INCREMENTAL_HOPS) continue;
+        for (int j = 0; j < vertices[v].edge_num; j++) {
+            int neighbor = vertices[v].conn[j];
+            if (hops[neighbor] >= 0) continue;
+            hops[neighbor] = hops[v] + 1;
+            queue[region++] = neighbor;
+        }
+    }
+    printf("Zmienione wierzcholki: %d, obszar poprawy: %d\n", changed, region);
+
+    int total_weight = 0;
+    for (int i = 0; i < vertex_count; i++) total_weight += vertices[i].weight;
+    int target = total_weight / parts;
+    int margin = (error_margin < 0) ? 0 : (int)(target * error_margin / 100.0);
+    int max_size = target + margin;
+    if (max_size * parts < total_weight) max_size = (total_weight + parts - 1) / parts;
+    if (region > 0) {
+        refine_boundary_region(vertex_count, parts, target - margin, max_size, queue, region);
+        // usuniete krawedzie mogly rozspojnic grupe
+        fix_group_connectivity(vertex_count, parts, target - margin, max_size);
+    }
+
+    free(mark);
+    free(queue);
+    free(hops);
+    free(link);
+    free_previous_partition(&prev);
+}
@@ -0,0 +1,25 @@
+#ifndef INCREMENTAL_PARTITION_H
+#define INCREMENTAL_PARTITION_H
+
+#define INCREMENTAL_HOPS 2   // promien (w krawedziach) obszaru poprawy wokol zmienionych wierzcholkow
+
+// Wynik poprzedniego podzialu (--previous): ASCII, binarny albo strumieniowy (ldg/fennel)
+typedef struct previous_partition {
+    int vertex_count;
+    int parts;
+    int *group;
+    int *row;       // wiersze CSR sasiadow z tej samej grupy, NULL dla wyniku strumieniowego (bez krawedzi)
+    int *adj;
+} PreviousPartition;
+
+extern char *previous_file;
+
+void load_previous_partition(const char *filename, PreviousPartition *prev);
+void free_previous_partition(PreviousPartition *prev);
+// Podzial przyrostowy: wierzcholki zachowuja grupy z poprzedniego wyniku, nowe dostaja grupe wiekszosci sasiadow.
+// Zmienione sa wierzcholki nowe i te, ktorych lista sasiadow z tej samej grupy rozni sie od zapisanej (wynik
+// zawiera tylko krawedzie wewnatrz grup, wiec zmiany krawedzi miedzy grupami nie sa widoczne). Poprawa brzegu
+// rusza tylko z obszaru INCREMENTAL_HOPS wokol zmian i przenosi wierzcholek tylko przy dodatnim zysku.
+void incremental_partitioning(const char *filename, int parts, int vertex_count, double error_margin);
+
+#endif //INCREMENTAL_PARTITION_H
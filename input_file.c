@@ -5,20 +5,30 @@
 #include <string.h>
 #include <math.h>
 #include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "graph_partition.h"
 #include "input_file.h"
+#include "binary_graph.h"
+#include "line_index.h"
 
-void read_file_error(FILE *file) {
-    if (file == NULL) {
+static _Thread_local char *mapped_graph = NULL;
+static _Thread_local size_t mapped_graph_size = 0;
+
+void read_file_error(int fd) {
+    if (fd < 0) {
         printf("Blad: bledne dane wejsciowe.\n");
         exit(14);
     }
 }
 
-void validate_graph_data(int max_matrix, int *x_coords, int x_count, int *y_offsets, int y_offsets_count, int *connections, int count_conn, int *offsets, int count_offsets, int parts, int error_margin) {
-    // sprawdzzenie zgdnosci 1 linii
-    if (max_matrix > 1024 || max_matrix < 0) {
-        printf("Blad: Niepoprawny format pliku wejsciowego. Pierwsza linia pliku musi byc w przedziale 0-1024.");
+void validate_graph_data(int max_matrix, int x_count, int *y_offsets, int y_offsets_count, int parts, int error_margin) {
+    // sprawdzzenie zgdnosci 1 linii (limit 1024 nie obowiazuje w trybie --wide)
+    if ((!wide_flag && max_matrix > 1024) || max_matrix < 0) {
+        printf("Blad: Niepoprawny format pliku wejsciowego. Pierwsza linia pliku musi byc w przedziale 0-1024 (wieksze siatki wymagaja flagi --wide).");
         exit(13);
     }
 
@@ -28,56 +38,13 @@ void validate_graph_data(int max_matrix, int *x_coords, int x_count, int *y_offs
         exit(13);
     }
 
-    // sprawdzenie czy  wspolrzedna x miesci sie od 0 do 1 linii
-    for (int i = 0; i < x_count; i++) {
-        if (x_coords[i] < 0) {
-            printf("Blad: Niepoprawny format pliku wejsciowego. Pozycja wierzcholka w 2 linii nie moze byc wartoscia mniejsza niz 0.");
-            exit(13);
-        }
-    }
-
-    for (int i = 0; i < y_offsets_count; i++) {
-        if (y_offsets[i] < 0) {
-            printf("Blad: Niepoprawny format pliku wejsciowego. Indeks pozycji wierzcholka w 3 linii nie moze byc wartoscia mniejsza niz 0.");
-            exit(13);
-        }
-    }
-
     // czy ilosc wierzcholkow z Y zgadza sie z iloscia z X
     if (y_offsets[y_offsets_count - 1] != x_count) {
         printf("Blad: Niepoprawny format pliku wejsciowego. Obliczona ilosc wierzcholkow z 2 linii nie zgadza sie z iloscia z 3 linii.");
         exit(13);
     }
 
-    // sprawdzenie czy liczby sa rosnaco w 3 linii
-    for (int i = 0; i < y_offsets_count - 1; i++) {
-        if (y_offsets[i] > y_offsets[i + 1]) {
-            printf("Blad: Niepoprawny format pliku wejsciowego. Indeksy pozycji w 3 linii musza byc uporzadkowane rosnaco");
-            exit(13);
-        }
-    }
-
-    // sprawdzenie polaczen z liczba wierzcholkow
-    for (int i = 0; i < count_conn; i++) {
-        if (connections[i] < 0 || connections[i] >= x_count) {
-            printf("Blad: Niepoprawny format pliku wejsciowego. Numer wierzcholka w linii 4 nie moze byc wiekszy niz ogolna liczba wierzcholkow.");
-            exit(13);
-        }
-    }
-
-    // sprawdzenie czy ostatni offset nie przekracza liczby krawedzi
-    if (offsets[count_offsets - 1] > count_conn) {
-        printf("Blad: Niepoprawny format pliku wejsciowego. Ostatni indeks polaczenia wierzcholka w 5 linii nie moze byc wiekszy niz liczba polaczen.");
-        exit(13);
-    }
-
-    // sprawdzenie czy offesty sa rosnace i poprawne
-    for (int i = 0; i < count_offsets - 1; i++) {
-        if (offsets[i] > offsets[i + 1] || offsets[i] > count_conn) {
-            printf("Blad: Niepoprawny format pliku wejsciowego. Indeksy polaczen w 5 linii musza byc uporzadkowane rosnaco, oraz nie moga przekraczac liczby polaczen.");
-            exit(13);
-        }
-    }
+    // wartosci w liniach 2-5 (zakresy, rosnace offsety) sprawdza parse_num_line w trakcie wczytywania
 
     int vertex_count = x_count;
     if(parts > (floor(vertex_count/2))) {
@@ -124,120 +91,261 @@ void validate_graph_data(int max_matrix, int *x_coords, int x_count, int *y_offs
 }
 
 
-void read_num_dynamic(FILE *file, int **array, int *count, int file_size) {
-    *count = 0;
-    size_t size = 128;
-    *array = malloc(size * sizeof(int));
+static void parse_error_token(const char *token, const char *line_end) {
+    int len = 0;
+    while (token + len < line_end && token[len] != ';' && token[len] != '\r') len++;
+    printf("Blad: Niepoprawny format pliku. Niedozwolony znak: '%.*s'. Znaki dozwolone to liczby i ';'.\n", len, token);
+    exit(13);
+}
+
+void check_value(LineKind kind, int val, int prev, int count, int limit) {
+    switch (kind) {
+        case LINE_X:
+            if (val < 0) {
+                printf("Blad: Niepoprawny format pliku wejsciowego. Pozycja wierzcholka w 2 linii nie moze byc wartoscia mniejsza niz 0.");
+                exit(13);
+            }
+            break;
+        case LINE_Y:
+            if (val < 0) {
+                printf("Blad: Niepoprawny format pliku wejsciowego. Indeks pozycji wierzcholka w 3 linii nie moze byc wartoscia mniejsza niz 0.");
+                exit(13);
+            }
+            if (count > 0 && prev > val) {
+                printf("Blad: Niepoprawny format pliku wejsciowego. Indeksy pozycji w 3 linii musza byc uporzadkowane rosnaco");
+                exit(13);
+            }
+            break;
+        case LINE_CONN:
+            if (val < 0 || val >= limit) {
+                printf("Blad: Niepoprawny format pliku wejsciowego. Numer wierzcholka w linii 4 nie moze byc wiekszy niz ogolna liczba wierzcholkow.");
+                exit(13);
+            }
+            break;
+        case LINE_OFFSETS:
+            if ((count > 0 && prev > val) || val > limit) {
+                printf("Blad: Niepoprawny format pliku wejsciowego. Indeksy polaczen w 5 linii musza byc uporzadkowane rosnaco, oraz nie moga przekraczac liczby polaczen.");
+                exit(13);
+            }
+            break;
+    }
+}
+
+const char *next_line(const char *pos, const char *end) {
+    const char *nl = memchr(pos, '\n', end - pos);
+    return nl ? nl + 1 : NULL;
+}
+
+const char *parse_num_line(const char *pos, const char *end, LineKind kind, int limit, int **array, int *count) {
+    const char *next = next_line(pos, end);
+    const char *line_end = next ? next - 1 : end;
+    if (line_end > pos && line_end[-1] == '\r') line_end--;
+
+    // kazda liczba zajmuje co najmniej 1 znak i separator, wiec bufor nigdy nie rosnie
+    size_t capacity = (size_t)(line_end - pos) / 2 + 1;
+    *array = malloc(capacity * sizeof(int));
     if (!*array) {
         printf("Blad pamieci.\n");
         exit(15);
     }
 
-    char *line = malloc(file_size);
-    if (!line) {
-        printf("Blad pamieci.\n");
-        exit(15);
+    *count = 0;
+    int prev = 0;
+    const char *p = pos;
+    while (p < line_end) {
+        while (p < line_end && *p == ' ') p++;
+        if (p == line_end) break;
+
+        const char *token = p;
+        int negative = 0;
+        if (*p == '-') {
+            negative = 1;
+            p++;
+        }
+        if (p == line_end || (unsigned)(*p - '0') > 9) parse_error_token(token, line_end);
+
+        long val = 0;
+        while (p < line_end && (unsigned)(*p - '0') <= 9) {
+            val = val * 10 + (*p - '0');
+            if (val > INT_MAX) parse_error_token(token, line_end);
+            p++;
+        }
+        while (p < line_end && *p == ' ') p++;
+        if (p < line_end) {
+            if (*p != ';') parse_error_token(token, line_end);
+            p++;
+        }
+
+        int v = (int)(negative ? -val : val);
+        check_value(kind, v, prev, *count, limit);
+        (*array)[(*count)++] = v;
+        prev = v;
     }
 
-    if (fgets(line, file_size, file) == NULL) {
+    if (*count == 0) {
         printf("Blad: Niepoprawny format pliku. Nie wczytano linii (sprawdz czy nie jest pusta).\n");
-        free(line);
         exit(13);
     }
+    return next;
+}
 
-    char *token = strtok(line, ";");
-    while (token != NULL) {
-        while (*token == ' ') token++;
-
-        char *endptr;
-        long val = strtol(token, &endptr, 10);
+void build_csr_adjacency(int vertex_count, const int *connections, const int *offsets, int count_offsets) {
+    // liczba wpisow wskazujacych na kazdy wierzcholek (krawedz zapisujemy w obie strony)
+    int *row_start = calloc(vertex_count + 1, sizeof(int));
+    if (!row_start) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
 
-        if (*endptr != '\0' && *endptr != '\n') {
-            printf("Blad: Niepoprawny format pliku. Niedozwolony znak: '%s'. Znaki dozwolone to liczby i ';'.\n", token);
-            free(line);
-            exit(13);
-        }
+    for (int i = 0; i < count_offsets - 1; i++) {
+        int start = offsets[i];
+        int end = offsets[i + 1];
+        if (start >= end) continue;
 
-        if (*count >= size) {
-            size *= 2;
-            *array = realloc(*array, size * sizeof(int));
-            if (!*array) {
-                printf("Blad pamieci.");
-                free(line);
-                exit(15);
-            }
+        int from = connections[start];
+        for (int j = start + 1; j < end; j++) {
+            int to = connections[j];
+            row_start[to + 1]++;
+            if (from != to) row_start[from + 1]++;
         }
+    }
+    for (int i = 0; i < vertex_count; i++) row_start[i + 1] += row_start[i];
 
-        (*array)[(*count)++] = (int)val;
-        token = strtok(NULL, ";");
+    int entry_count = row_start[vertex_count];
+    int *by_target = malloc((entry_count + 1) * sizeof(int));
+    int *fill = calloc(vertex_count, sizeof(int));
+    adjacency = malloc((entry_count + 1) * sizeof(int));
+    if (!by_target || !fill || !adjacency) {
+        printf("Blad pamieci.\n");
+        exit(15);
     }
-    free(line);
-}
 
-int count_lines(FILE *file) {
-    int lines = 1;
-    int ch;
-    long pos = ftell(file);
-    rewind(file);
-    while ((ch = fgetc(file)) != EOF) {
-        if (ch == '\n') lines++;
+    // 1. przebieg: kubelkowanie par (zrodlo, cel) po celu
+    for (int i = 0; i < count_offsets - 1; i++) {
+        int start = offsets[i];
+        int end = offsets[i + 1];
+        if (start >= end) continue;
+
+        int from = connections[start];
+        for (int j = start + 1; j < end; j++) {
+            int to = connections[j];
+            by_target[row_start[to] + fill[to]++] = from;
+            if (from != to) by_target[row_start[from] + fill[from]++] = to;
+        }
     }
-    fseek(file, pos, SEEK_SET);
-    return lines;
-}
 
-void skip_lines(FILE *file, int n, int file_size) {
-    char *line = malloc(file_size);
-    if (!line) {
-        printf("Blad pamieci.\n");
-        exit(15);
+    // 2. przebieg: przejscie po celach rosnaco daje posortowane wiersze bez sortowania porownawczego
+    for (int i = 0; i < vertex_count; i++) fill[i] = 0;
+    for (int target = 0; target < vertex_count; target++) {
+        for (int k = row_start[target]; k < row_start[target + 1]; k++) {
+            int source = by_target[k];
+            adjacency[row_start[source] + fill[source]++] = target;
+        }
     }
+    free(by_target);
 
-    for (int i=0; i < n; i++) {
-        if (fgets(line, file_size, file) == NULL) {
-            printf("Blad: Nie udalo sie wybrac danego grafu.");
-            exit(23);
+    // usuniecie powtorzonych krawedzi - sasiednie duplikaty w posortowanym wierszu
+    int write = 0;
+    for (int i = 0; i < vertex_count; i++) {
+        int begin = write;
+        for (int k = row_start[i]; k < row_start[i + 1]; k++) {
+            if (write == begin || adjacency[write - 1] != adjacency[k]) {
+                adjacency[write++] = adjacency[k];
+            }
         }
+        row_start[i] = begin;
+        vertices[i].edge_num = write - begin;
     }
-    free(line);
-}
 
-void read_file(char **input_file, int *vertex_count, int choose_graph, int parts, double error_margin) {
-    FILE *file = fopen(*input_file, "r");
-    read_file_error(file);
+    int *shrunk = realloc(adjacency, (write + 1) * sizeof(int));
+    if (shrunk) adjacency = shrunk;
 
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    for (int i = 0; i < vertex_count; i++) {
+        vertices[i].conn = adjacency + row_start[i];
+    }
+
+    free(fill);
+    free(row_start);
+}
 
+void open_graph_source(const char *input_file, GraphSource *src) {
+    memset(src, 0, sizeof(*src));
+    src->fd = open(input_file, O_RDONLY);
+    read_file_error(src->fd);
 
-    int line_count = count_lines(file);
-    if (line_count < 5) {
+    src->input_file = input_file;
+    struct stat st;
+    if (fstat(src->fd, &st) != 0 || st.st_size == 0) {
         printf("Blad: Niepoprawny format pliku. Plik musi zawierac przynajmniej 5 linii danych.\n");
         exit(13);
     }
-    if (line_count > 5 && choose_graph == 0) {
-        printf("Blad: Wykryto wieksza ilosc grafow w pliku. Zdefiniuj z ktorego korzystasz");
-        exit(24);
+    src->size = st.st_size;
+    src->st = st;
+
+    // PROT_WRITE przy MAP_PRIVATE - binarny graf jest modyfikowany w miejscu (kopia przy zapisie)
+    src->data = mmap(NULL, src->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, src->fd, 0);
+    if (src->data == MAP_FAILED) {
+        printf("Blad: bledne dane wejsciowe.\n");
+        exit(14);
     }
-    if (line_count == 5 && choose_graph != 0) {
-        printf("Blad: Nie mozna wybrac grafu.\n");
-        exit(25);
+
+    if (is_binary_graph(src->data, src->size)) {
+        src->binary = 1;
+        return;
     }
-    if (choose_graph > (line_count - 4)) {
-        printf("Blad: Program nie wykryl takiego grafu.\n");
-        exit(26);
+    madvise(src->data, src->size, MADV_SEQUENTIAL);
+    const char *end = src->data + src->size;
+
+    // liczba linii i poczatki linii 2-4 z indeksu <plik>.idx, a gdy go brak lub jest nieaktualny - z przegladu memchr
+    static const int header_numbers[3] = { 1, 2, 3 };
+    const char *header_lines[3];
+    src->line_count = load_line_index(input_file, &st, src->data, src->size, header_numbers, 3, header_lines);
+    if (src->line_count == 0) {
+        int capacity = 16;
+        src->lines = malloc(capacity * sizeof(const char *));
+        if (!src->lines) {
+            printf("Blad pamieci.\n");
+            exit(15);
+        }
+        for (const char *p = src->data; p != NULL; p = next_line(p, end)) {
+            if (src->line_count >= capacity) {
+                capacity *= 2;
+                src->lines = realloc(src->lines, capacity * sizeof(const char *));
+                if (!src->lines) {
+                    printf("Blad pamieci.\n");
+                    exit(15);
+                }
+            }
+            src->lines[src->line_count++] = p;
+        }
+        // wybor grafu ma znaczenie tylko przy wielu liniach offsetow
+        if (src->line_count > 5) save_line_index(input_file, &st, src->data, src->size, src->lines, src->line_count);
     }
 
-    int max_matrix = 0;
-    int ch;
-    int digit_found = 0, non_digit_found = 0;
-    long cursor_pos = ftell(file);
+    if (src->line_count < 5) {
+        printf("Blad: Niepoprawny format pliku. Plik musi zawierac przynajmniej 5 linii danych.\n");
+        exit(13);
+    }
+    if (src->lines) {
+        for (int i = 0; i < 3; i++) header_lines[i] = src->lines[header_numbers[i]];
+        src->graph_lines = src->lines + 4;
+    }
+    const char *line2 = header_lines[0];
+    const char *line3 = header_lines[1];
+    const char *line4 = header_lines[2];
+    src->graph_count = src->line_count - 4;
 
-    while ((ch = fgetc(file)) != '\n' && ch != EOF) {
-        if (isdigit(ch)) {
+    long first_line = 0;
+    int digit_found = 0, non_digit_found = 0;
+    for (const char *p = src->data; p < line2 - 1; p++) {
+        if (isdigit((unsigned char)*p)) {
             digit_found = 1;
-        } else if (!isspace(ch)) {
+            first_line = first_line * 10 + (*p - '0');
+            if (first_line > INT_MAX) {
+                printf("Blad: Niepoprawny format pliku. Liczba poza zakresem.\n");
+                exit(13);
+            }
+        } else if (!isspace((unsigned char)*p)) {
             non_digit_found = 1;
         }
     }
@@ -245,35 +353,38 @@ void read_file(char **input_file, int *vertex_count, int choose_graph, int parts
         printf("Blad: Niepoprawny format pliku wejsciowego. W 1 linii wykryto niedozwolony znak, program przyjmuje tylko liczbe calkowita.");
         exit(13);
     }
+    max_matrix = (int)first_line;
 
-    fseek(file, cursor_pos, SEEK_SET);
-    fscanf(file, "%d", &max_matrix);
-
-    while ((ch = fgetc(file)) != '\n' && ch != EOF);
-
-    int *x_coords = NULL;
-    int x_count = 0;
-    read_num_dynamic(file, &x_coords, &x_count, file_size);
+    parse_num_line(line2, end, LINE_X, 0, &src->x_coords, &src->x_count);
+    parse_num_line(line3, end, LINE_Y, 0, &src->y_offsets, &src->y_offsets_count);
+    parse_num_line(line4, end, LINE_CONN, src->x_count, &src->connections, &src->count_conn);
+    row_count = src->y_offsets_count - 1;
+}
 
-    int *y_offsets = NULL;
-    int y_offsets_count = 0;
-    read_num_dynamic(file, &y_offsets, &y_offsets_count, file_size);
+static const char *graph_line(const GraphSource *src, int graph) {
+    if (src->graph_lines) return src->graph_lines[graph];
 
-    int *connections = NULL;
-    int count_conn = 0;
-    read_num_dynamic(file, &connections, &count_conn, file_size);
+    int line = graph + 4;
+    const char *start;
+    if (load_line_index(src->input_file, &src->st, src->data, src->size, &line, 1, &start) == src->line_count) return start;
+    // uszkodzony wpis indeksu - linia szukana przegladem pliku
+    start = src->data;
+    for (int i = 0; i < line && start != NULL; i++) start = next_line(start, src->data + src->size);
+    if (start == NULL) {
+        printf("Blad: Niepoprawny format pliku. Plik musi zawierac przynajmniej 5 linii danych.\n");
+        exit(13);
+    }
+    return start;
+}
 
+void load_graph(const GraphSource *src, int graph, int *vertex_count, int parts, double error_margin) {
     int *offsets = NULL;
     int count_offsets = 0;
+    parse_num_line(graph_line(src, graph), src->data + src->size, LINE_OFFSETS, src->count_conn, &offsets, &count_offsets);
 
-    if (choose_graph > 0) {
-        skip_lines(file, choose_graph - 1, file_size);
-    }
-    read_num_dynamic(file, &offsets, &count_offsets, file_size);
-
-    validate_graph_data(max_matrix, x_coords, x_count, y_offsets, y_offsets_count, connections, count_conn, offsets, count_offsets, parts, error_margin);
+    validate_graph_data(max_matrix, src->x_count, src->y_offsets, src->y_offsets_count, parts, error_margin);
 
-    *vertex_count = x_count;
+    *vertex_count = src->x_count;
     vertices = malloc(*vertex_count * sizeof(Vertex));
     if (!vertices) {
         printf("Blad pamieci.\n");
@@ -281,82 +392,81 @@ void read_file(char **input_file, int *vertex_count, int choose_graph, int parts
     }
 
     for (int i = 0; i < *vertex_count; i++) {
-        vertices[i].x = x_coords[i];
+        vertices[i].x = src->x_coords[i];
+        vertices[i].y = 0;
         vertices[i].fixed = 0;
         vertices[i].group = 0;
         vertices[i].D = 0;
+        vertices[i].weight = 1;
+        vertices[i].weights = NULL;
         vertices[i].edge_num = 0;
         vertices[i].conn = NULL;
-
-        for (int y = 0; y < y_offsets_count - 1; y++) {
-            if (i >= y_offsets[y] && i < y_offsets[y + 1]) {
-                vertices[i].y = y;
-                break;
-            }
-        }
-    }
-
-    int **adjacency = malloc(*vertex_count * sizeof(int *));
-    if (!adjacency) {
-        printf("Blad pamieci.\n");
-        exit(15);
     }
 
-    for (int i = 0; i < *vertex_count; i++) {
-        adjacency[i] = calloc(*vertex_count, sizeof(int));
-        if (!adjacency[i]) {
-            printf("Blad pamieci.\n");
-            exit(15);
+    // wiersz (y) kazdego wierzcholka wynika bezposrednio z przedzialow 3 linii
+    for (int y = 0; y < src->y_offsets_count - 1; y++) {
+        for (int i = src->y_offsets[y]; i < src->y_offsets[y + 1] && i < *vertex_count; i++) {
+            vertices[i].y = y;
         }
     }
 
-    for (int i = 0; i < count_offsets - 1; i++) {
-        int start = offsets[i];
-        int end = offsets[i + 1];
-        if (start >= end) continue;
+    build_csr_adjacency(*vertex_count, src->connections, offsets, count_offsets);
+    free(offsets);
+}
 
-        int from = connections[start];
-        for (int j = start + 1; j < end; j++) {
-            int to = connections[j];
-            if (!adjacency[from][to]) {
-                adjacency[from][to] = 1;
-                adjacency[to][from] = 1;
-                vertices[from].edge_num++;
-                vertices[to].edge_num++;
-            }
-        }
-    }
+void close_graph_source(GraphSource *src) {
+    free(src->x_coords);
+    free(src->y_offsets);
+    free(src->connections);
+    free(src->lines);
+    if (src->data != NULL && src->data != MAP_FAILED) munmap(src->data, src->size);
+    close(src->fd);
+}
 
-    for (int i = 0; i < *vertex_count; i++) {
-        if (vertices[i].edge_num > 0) {
-            vertices[i].conn = malloc(vertices[i].edge_num * sizeof(int));
-            if (!vertices[i].conn) {
-                printf("Blad pamieci.");
-                exit(15);
-            }
-        } else {
-            vertices[i].conn = NULL;
+void read_file(char **input_file, int *vertex_count, int choose_graph, int parts, double error_margin) {
+    GraphSource src;
+    open_graph_source(*input_file, &src);
+
+    if (src.binary) {
+        // plik binarny zawiera zawsze jeden graf - jak przy pliku tekstowym z jedna linia offsetow
+        if (choose_graph != 0) {
+            printf("Blad: Nie mozna wybrac grafu.\n");
+            exit(25);
         }
-        vertices[i].edge_num = 0;
+        // mapowanie zostaje do free_graph - sasiedzi sa uzywani bezposrednio z pliku
+        read_binary_graph(src.data, src.size, vertex_count, parts, error_margin);
+        mapped_graph = src.data;
+        mapped_graph_size = src.size;
+        close(src.fd);
+        return;
     }
 
-    for (int i = 0; i < *vertex_count; i++) {
-        for (int j = 0; j < *vertex_count; j++) {
-            if (adjacency[i][j]) {
-                vertices[i].conn[vertices[i].edge_num++] = j;
-            }
-        }
+    int line_count = src.graph_count + 4;
+    if (line_count > 5 && choose_graph == 0) {
+        printf("Blad: Wykryto wieksza ilosc grafow w pliku. Zdefiniuj z ktorego korzystasz");
+        exit(24);
     }
-
-    for (int i = 0; i < *vertex_count; i++) {
-        free(adjacency[i]);
+    if (line_count == 5 && choose_graph != 0) {
+        printf("Blad: Nie mozna wybrac grafu.\n");
+        exit(25);
+    }
+    if (choose_graph > (line_count - 4)) {
+        printf("Blad: Program nie wykryl takiego grafu.\n");
+        exit(26);
     }
-    free(adjacency);
 
-    free(x_coords);
-    free(y_offsets);
-    free(connections);
-    free(offsets);
+    load_graph(&src, choose_graph > 0 ? choose_graph - 1 : 0, vertex_count, parts, error_margin);
+    close_graph_source(&src);
+}
 
-    fclose(file);
+void free_graph(void) {
+    if (mapped_graph) {
+        munmap(mapped_graph, mapped_graph_size);
+        mapped_graph = NULL;
+    } else {
+        free(adjacency);
+    }
+    adjacency = NULL;
+    free(vertices);
+    vertices = NULL;
 }
\ No newline at end of file
@@ -1,13 +1,48 @@
 #ifndef INPUT_FILE_H
 #define INPUT_FILE_H
 #include <stdio.h>
+#include <stddef.h>
+#include <sys/stat.h>
 
-void read_file_error(FILE *file);
-void validate_graph_data(int max_matrix, int *x_coords, int x_count, int *y_offsets, int y_offsets_count, int *connections, int count_conn, int *offsets, int count_offsets, int parts, int error_margin);
-void read_num_dynamic(FILE *file, int **array, int *count, int file_size);
-int count_lines(FILE *file);
-void skip_lines(FILE *file, int n, int file_size);
+typedef enum line_kind {
+    LINE_X,
+    LINE_Y,
+    LINE_CONN,
+    LINE_OFFSETS
+} LineKind;
+
+// Zmapowany plik .csrrg ze sparsowanymi wspolnymi liniami 2-4 i poczatkami linii offsetow (po jednej na graf).
+// Przy aktualnym indeksie <plik>.idx lines i graph_lines sa NULL - linia grafu czytana jest z indeksu w load_graph.
+typedef struct graph_source {
+    const char *input_file;
+    struct stat st;
+    int fd;
+    char *data;
+    size_t size;
+    int binary;
+    int *x_coords;
+    int x_count;
+    int *y_offsets;
+    int y_offsets_count;
+    int *connections;
+    int count_conn;
+    const char **lines;
+    int line_count;
+    const char **graph_lines;
+    int graph_count;
+} GraphSource;
+
+void read_file_error(int fd);
+void validate_graph_data(int max_matrix, int x_count, int *y_offsets, int y_offsets_count, int parts, int error_margin);
+void check_value(LineKind kind, int val, int prev, int count, int limit);
+const char *next_line(const char *pos, const char *end);
+const char *parse_num_line(const char *pos, const char *end, LineKind kind, int limit, int **array, int *count);
+void build_csr_adjacency(int vertex_count, const int *connections, const int *offsets, int count_offsets);
+void open_graph_source(const char *input_file, GraphSource *src);
+void load_graph(const GraphSource *src, int graph, int *vertex_count, int parts, double error_margin);
+void close_graph_source(GraphSource *src);
 void read_file(char **input_file, int *vertex_count, int choose_graph, int parts, double error_margin);
+void free_graph(void);
 
 
 #endif //INPUT_FILE_H
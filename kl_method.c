@@ -3,8 +3,65 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <stdint.h>
+#include <limits.h>
 #include "kl_method.h"
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 #include "graph_partition.h"
+#include "graph_utils.h"
+#include "graph_growing.h"
+#include "thread_pool.h"
+
+typedef struct kl_sweep {
+    Vertex *graph;
+    int vertex_count;
+    int min_group;
+    const int *order;   // kolejnosc rosniecia grafu wspolna dla wszystkich rozmiarow
+    int best_cut;
+    int best_size;
+    int *best_groups;
+    pthread_mutex_t lock;
+} KLSweep;
+
+typedef struct kl_multi_start {
+    Vertex *graph;
+    int vertex_count;
+    int min_group;
+    int max_group;
+    const int *order;       // kolejnosc deterministycznego startu 0
+    atomic_llong best_key;  // (ciecie << 32) | numer startu - najmniejszy klucz wygrywa
+    int *best_groups;
+    pthread_mutex_t lock;
+} KLMultiStart;
+
+int kl_restarts = 0;
+unsigned long long kl_seed = 0;
+double kl_time_limit = 0;
+static double kl_deadline = 0;
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void kl_start_clock(void) {
+    if (kl_time_limit > 0) kl_deadline = monotonic_seconds() + kl_time_limit;
+}
+
+int kl_time_expired(void) {
+    return kl_deadline > 0 && monotonic_seconds() >= kl_deadline;
+}
+
+// splitmix64 - osobny generator dla kazdego startu, wiec wynik nie zalezy od liczby watkow
+static unsigned long long next_random(unsigned long long *state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
 
 void reset_fixed_flags(int vertex_count) {
     for (int i = 0; i < vertex_count; i++) {
@@ -12,24 +69,23 @@ void reset_fixed_flags(int vertex_count) {
     }
 }
 
-void initial_bipartition(int vertex_count, int group1_size) {
-    for (int i = 0; i < vertex_count; i++) {
-        vertices[i].group = (i < group1_size) ? 0 : 1;
+static void assign_grown_groups(const int *order, int vertex_count, int group1_size) {
+    for (int p = 0; p < vertex_count; p++) {
+        vertices[order[p]].group = (p < group1_size) ? 0 : 1;
     }
 }
 
-int edge_cut_counter(int one_group_vertices_count) {
-    int edge_cut_count = 0;
-    for (int i = 0; i < one_group_vertices_count; i++) {
-        if (vertices[i].conn == NULL) continue;
-        for (int j = 0; j < vertices[i].edge_num; j++) {
-            int neighbour = vertices[i].conn[j];
-            if (vertices[i].group != vertices[neighbour].group) {
-                edge_cut_count++;
-            }
-        }
+// grupa 0 to pierwsze group1_size wierzcholkow BFS z wierzcholka pseudo-peryferyjnego - spojny obszar z krotkim
+// brzegiem zamiast podzialu po numerach, wiec KL startuje z dobrego ciecia i konczy po kilku przebiegach
+void initial_bipartition(int vertex_count, int group1_size) {
+    int *order = malloc(vertex_count * sizeof(int));
+    if (!order) {
+        printf("Blad pamieci.");
+        exit(15);
     }
-    return edge_cut_count;
+    graph_growing_order(vertices, vertex_count, group1_size, order);
+    assign_grown_groups(order, vertex_count, group1_size);
+    free(order);
 }
 
 int calc_G(int first_vertex, int second_vertex, int vertex_count) {
@@ -42,7 +98,7 @@ int calc_G(int first_vertex, int second_vertex, int vertex_count) {
     if (vertices[first_vertex].conn != NULL) {
         for (int i = 0; i < vertices[first_vertex].edge_num; i++) {
             if (vertices[first_vertex].conn[i] == second_vertex) {
-                connection = 1;
+                connection = edge_weight(&vertices[first_vertex], i);
                 break;
             }
         }
@@ -62,18 +118,17 @@ void calc_D(int counter) {
     for (int i = 0; i < vertices[counter].edge_num; i++) {
         int neighbour = vertices[counter].conn[i];
         if (vertices[counter].group != vertices[neighbour].group) {
-            external_edges++;
+            external_edges += edge_weight(&vertices[counter], i);
         } else {
-            internal_edges++;
+            internal_edges += edge_weight(&vertices[counter], i);
         }
     }
 
     vertices[counter].D = external_edges - internal_edges;
 }
 
-int kernighan_lin_algorithm(int one_group_vertices_count, int vertex_count) {
-    int edge_cut = edge_cut_counter(one_group_vertices_count);
-    int group2_size = vertex_count - one_group_vertices_count;
+int kernighan_lin_algorithm(int vertex_count) {
+    int edge_cut = cut_size(vertex_count);
     int best_cut = edge_cut;
 
     int *initial_groups = malloc(vertex_count * sizeof(int));
@@ -85,23 +140,38 @@ int kernighan_lin_algorithm(int one_group_vertices_count, int vertex_count) {
         initial_groups[i] = vertices[i].group;
     }
 
-    int *gain = malloc(one_group_vertices_count * group2_size * sizeof(int));
-    Swap *swaps = malloc(one_group_vertices_count * sizeof(Swap));
+    Swap *swaps = malloc((vertex_count / 2 + 1) * sizeof(Swap));
+    int *side0 = malloc(vertex_count * sizeof(int));
+    int *side1 = malloc(vertex_count * sizeof(int));
+    if (!swaps || !side0 || !side1) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
 
-    while (1) {
+    // po przekroczeniu --time-limit przerywamy przebieg i zostaje najlepszy podzial znaleziony do tej pory
+    while (!kl_time_expired()) {
         for (int i = 0; i < vertex_count; i++) calc_D(i);
         reset_fixed_flags(vertex_count);
 
+        // grupy nie musza zajmowac kolejnych numerow (start z rosniecia grafu) - listy budowane co przebieg
+        int count0 = 0, count1 = 0;
+        for (int i = 0; i < vertex_count; i++) {
+            if (vertices[i].group == 0) side0[count0++] = i;
+            else side1[count1++] = i;
+        }
+        int pair_count = count0 < count1 ? count0 : count1;
+
         int swap_count = 0;
 
-        for (int s = 0; s < one_group_vertices_count; s++) {
-            int max_gain = -999999;
+        for (int s = 0; s < pair_count && !kl_time_expired(); s++) {
+            int max_gain = INT_MIN;
             int best_i = -1, best_j = -1;
 
-            for (int i = 0; i < one_group_vertices_count; i++) {
+            for (int a = 0; a < count0; a++) {
+                int i = side0[a];
                 if (vertices[i].fixed) continue;
-                for (int j = 0; j < group2_size; j++) {
-                    int idx_j = j + one_group_vertices_count;
+                for (int b = 0; b < count1; b++) {
+                    int idx_j = side1[b];
                     if (vertices[idx_j].fixed) continue;
                     int g_val = calc_G(i, idx_j, vertex_count);
                     if (g_val > max_gain) {
@@ -119,7 +189,7 @@ int kernighan_lin_algorithm(int one_group_vertices_count, int vertex_count) {
             swaps[swap_count++] = (Swap){best_i, best_j, max_gain};
         }
 
-        int prefix_sum = 0, max_prefix_sum = -999999, k_max = -1;
+        int prefix_sum = 0, max_prefix_sum = INT_MIN, k_max = -1;
         for (int i = 0; i < swap_count; i++) {
             prefix_sum += swaps[i].gain;
             if (prefix_sum > max_prefix_sum) {
@@ -138,7 +208,7 @@ int kernighan_lin_algorithm(int one_group_vertices_count, int vertex_count) {
             vertices[b].group = tmp;
         }
 
-        edge_cut = edge_cut_counter(one_group_vertices_count);
+        edge_cut = cut_size(vertex_count);
         if (edge_cut < best_cut) {
             best_cut = edge_cut;
             for (int i = 0; i < vertex_count; i++) initial_groups[i] = vertices[i].group;
@@ -149,8 +219,147 @@ int kernighan_lin_algorithm(int one_group_vertices_count, int vertex_count) {
         vertices[i].group = initial_groups[i];
     }
 
-    free(gain);
     free(swaps);
+    free(side0);
+    free(side1);
     free(initial_groups);
     return best_cut;
-}
\ No newline at end of file
+}
+
+static void kl_size_task(int index, void *arg) {
+    KLSweep *sweep = arg;
+    // po limicie czasu kolejne rozmiary nie startuja; pierwszy zawsze, zeby byl jakis wynik
+    if (index > 0 && kl_time_expired()) return;
+    int n = sweep->vertex_count;
+    int size = sweep->min_group + index;
+
+    // wlasna kopia pol group/fixed/D - tablice sasiadow sa wspolne i tylko czytane
+    Vertex *copy = malloc(n * sizeof(Vertex));
+    if (!copy) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    memcpy(copy, sweep->graph, n * sizeof(Vertex));
+
+    Vertex *saved = vertices;
+    vertices = copy;
+    reset_fixed_flags(n);
+    assign_grown_groups(sweep->order, n, size);
+    kernighan_lin_algorithm(n);
+    int cut = cut_size(n);
+
+    // remis rozstrzyga mniejszy rozmiar - wynik nie zalezy od liczby watkow ani kolejnosci zadan
+    pthread_mutex_lock(&sweep->lock);
+    if (cut < sweep->best_cut || (cut == sweep->best_cut && size < sweep->best_size)) {
+        sweep->best_cut = cut;
+        sweep->best_size = size;
+        for (int i = 0; i < n; i++) sweep->best_groups[i] = copy[i].group;
+    }
+    pthread_mutex_unlock(&sweep->lock);
+
+    vertices = saved;
+    free(copy);
+}
+
+static void kl_restart_task(int index, void *arg) {
+    KLMultiStart *ms = arg;
+    // start 0 zawsze sie wykonuje - przy limicie czasu jest z czego zwrocic wynik
+    if (index > 0 && kl_time_expired()) return;
+    int n = ms->vertex_count;
+
+    Vertex *copy = malloc(n * sizeof(Vertex));
+    int *order = malloc(n * sizeof(int));
+    if (!copy || !order) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    memcpy(copy, ms->graph, n * sizeof(Vertex));
+
+    // start 0 jak bez --restarts (rosniecie z wierzcholka peryferyjnego, srodek okna), pozostale losowe:
+    // BFS z losowego wierzcholka i losowy rozmiar grupy 0 z okna marginesu
+    int size = (ms->min_group + ms->max_group) / 2;
+    if (index == 0) {
+        memcpy(order, ms->order, n * sizeof(int));
+    } else {
+        unsigned long long state = kl_seed ^ (0xD1B54A32D192ED03ULL * (unsigned long long)index);
+        size = ms->min_group + (int)(next_random(&state) % (unsigned long long)(ms->max_group - ms->min_group + 1));
+        graph_growing_from(copy, n, (int)(next_random(&state) % (unsigned long long)n), order);
+    }
+
+    Vertex *saved = vertices;
+    vertices = copy;
+    reset_fixed_flags(n);
+    assign_grown_groups(order, n, size);
+    kernighan_lin_algorithm(n);
+    long long key = ((long long)cut_size(n) << 32) | index;
+
+    // najmniejszy klucz ustawiany przez CAS; grupy kopiuje tylko start, ktorego klucz nadal jest najlepszy
+    long long best = atomic_load(&ms->best_key);
+    while (key < best) {
+        if (atomic_compare_exchange_weak(&ms->best_key, &best, key)) {
+            pthread_mutex_lock(&ms->lock);
+            if (atomic_load(&ms->best_key) == key) {
+                for (int i = 0; i < n; i++) ms->best_groups[i] = copy[i].group;
+            }
+            pthread_mutex_unlock(&ms->lock);
+            break;
+        }
+    }
+
+    vertices = saved;
+    free(copy);
+    free(order);
+}
+
+// --restarts N: N niezaleznych startow KL na puli watkow zamiast przegladu wszystkich rozmiarow z okna
+static int kl_multi_start(int vertex_count, int min_group, int max_group, int *best_groups) {
+    KLMultiStart ms;
+    ms.graph = vertices;
+    ms.vertex_count = vertex_count;
+    ms.min_group = min_group;
+    ms.max_group = max_group;
+    ms.best_groups = best_groups;
+    atomic_init(&ms.best_key, LLONG_MAX);
+    pthread_mutex_init(&ms.lock, NULL);
+    int *order = malloc(vertex_count * sizeof(int));
+    if (!order) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    graph_growing_order(vertices, vertex_count, (min_group + max_group) / 2, order);
+    ms.order = order;
+
+    parallel_for(kl_restarts, kl_restart_task, &ms);
+
+    pthread_mutex_destroy(&ms.lock);
+    free(order);
+    long long best = atomic_load(&ms.best_key);
+    return best == LLONG_MAX ? INT_MAX : (int)(best >> 32);
+}
+
+int kl_size_sweep(int vertex_count, int min_group, int max_group, int *best_groups) {
+    if (kl_restarts > 0) return kl_multi_start(vertex_count, min_group, max_group, best_groups);
+
+    KLSweep sweep;
+    sweep.graph = vertices;
+    sweep.vertex_count = vertex_count;
+    sweep.min_group = min_group;
+    sweep.best_cut = INT_MAX;
+    // jedna kolejnosc rosniecia (punkt startowy wybrany dla srodka okna) dla wszystkich rozmiarow
+    int *order = malloc(vertex_count * sizeof(int));
+    if (!order) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    graph_growing_order(vertices, vertex_count, (min_group + max_group) / 2, order);
+    sweep.order = order;
+    sweep.best_size = INT_MAX;
+    sweep.best_groups = best_groups;
+    pthread_mutex_init(&sweep.lock, NULL);
+
+    parallel_for(max_group - min_group + 1, kl_size_task, &sweep);
+
+    pthread_mutex_destroy(&sweep.lock);
+    free(order);
+    return sweep.best_cut;
+}
@@ -7,12 +7,18 @@ typedef struct swap {
     int gain;
 } Swap;
 
-int kernighan_lin_algorithm(int one_group_vertices_count, int vertex_count);
+extern int kl_restarts;               // --restarts: 0 - przeglad rozmiarow z jednego startu
+extern unsigned long long kl_seed;    // --seed
+extern double kl_time_limit;          // --time-limit w sekundach, 0 - bez limitu
+
+void kl_start_clock(void);
+int kl_time_expired(void);
+int kernighan_lin_algorithm(int vertex_count);
+int kl_size_sweep(int vertex_count, int min_group, int max_group, int *best_groups);
 
 void initial_bipartition(int vertex_count, int group1_size);
 void calc_D(int counter);
 int calc_G(int first_vertex, int second_vertex, int vertex_count);
 void reset_fixed_flags(int vertex_count);
-int edge_cut_counter(int one_group_vertices_count);
 
 #endif // KL_METHOD_H
@@ -0,0 +1,229 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <stdint.h>
+#include "kmeans.h"
+#include "thread_pool.h"
+
+typedef struct kmeans_state {
+    const double *points;   // wierszami: punkt i pod points[i * dims]
+    int n;
+    int dims;
+    int k;
+    double *centers;
+    int center_count;       // przy losowaniu k-means++ liczba juz wybranych srodkow
+    double *nearest;        // kwadrat odleglosci do najblizszego srodka
+    double *regret;         // strata przy przydziale do drugiego srodka zamiast pierwszego
+    const int *assignment;
+    const int *weights;     // NULL - kazdy punkt waga 1
+    double *block_sums;     // na blok: k * dims sum wspolrzednych (wazonych)
+} KMeansState;
+
+typedef struct regret_entry {
+    int index;
+    double regret;
+} RegretEntry;
+
+static int point_weight(const KMeansState *s, int i) {
+    return s->weights ? s->weights[i] : 1;
+}
+
+static double squared_distance(const double *a, const double *b, int dims) {
+    double sum = 0;
+    for (int d = 0; d < dims; d++) {
+        double diff = a[d] - b[d];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+static double next_random(uint64_t *state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double)(*state >> 11) / 9007199254740992.0;
+}
+
+// k-means++: odleglosc do ostatnio dodanego srodka skraca nearest
+static void seed_distance_task(int block, void *arg) {
+    KMeansState *s = arg;
+    const double *center = s->centers + (size_t)(s->center_count - 1) * s->dims;
+    int last = (block + 1) * KMEANS_BLOCK < s->n ? (block + 1) * KMEANS_BLOCK : s->n;
+    for (int i = block * KMEANS_BLOCK; i < last; i++) {
+        double d = squared_distance(s->points + (size_t)i * s->dims, center, s->dims);
+        if (d < s->nearest[i]) s->nearest[i] = d;
+    }
+}
+
+static void distance_task(int block, void *arg) {
+    KMeansState *s = arg;
+    int last = (block + 1) * KMEANS_BLOCK < s->n ? (block + 1) * KMEANS_BLOCK : s->n;
+    for (int i = block * KMEANS_BLOCK; i < last; i++) {
+        double best = DBL_MAX, second = DBL_MAX;
+        for (int c = 0; c < s->k; c++) {
+            double d = squared_distance(s->points + (size_t)i * s->dims, s->centers + (size_t)c * s->dims, s->dims);
+            if (d < best) {
+                second = best;
+                best = d;
+            } else if (d < second) {
+                second = d;
+            }
+        }
+        s->nearest[i] = best;
+        s->regret[i] = (s->k > 1) ? second - best : 0;
+    }
+}
+
+static void centroid_task(int block, void *arg) {
+    KMeansState *s = arg;
+    double *sums = s->block_sums + (size_t)block * s->k * s->dims;
+    memset(sums, 0, (size_t)s->k * s->dims * sizeof(double));
+    int last = (block + 1) * KMEANS_BLOCK < s->n ? (block + 1) * KMEANS_BLOCK : s->n;
+    for (int i = block * KMEANS_BLOCK; i < last; i++) {
+        int c = s->assignment[i];
+        int w = point_weight(s, i);
+        for (int d = 0; d < s->dims; d++) sums[(size_t)c * s->dims + d] += w * s->points[(size_t)i * s->dims + d];
+    }
+}
+
+static int cmp_regret(const void *a, const void *b) {
+    const RegretEntry *ra = a, *rb = b;
+    if (ra->regret != rb->regret) return (ra->regret < rb->regret) ? 1 : -1;
+    return ra->index - rb->index;
+}
+
+static void seed_centers(KMeansState *s, int blocks) {
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    int first = (int)(next_random(&state) * s->n);
+    if (first >= s->n) first = s->n - 1;
+    memcpy(s->centers, s->points + (size_t)first * s->dims, s->dims * sizeof(double));
+    for (int i = 0; i < s->n; i++) s->nearest[i] = DBL_MAX;
+
+    for (s->center_count = 1; s->center_count < s->k; s->center_count++) {
+        parallel_for(blocks, seed_distance_task, s);
+
+        // losowanie z prawdopodobienstwem proporcjonalnym do kwadratu odleglosci
+        double total = 0;
+        for (int i = 0; i < s->n; i++) total += s->nearest[i];
+        int chosen = s->n - 1;
+        if (total > 0) {
+            double target = next_random(&state) * total;
+            for (int i = 0; i < s->n; i++) {
+                target -= s->nearest[i];
+                if (target < 0) {
+                    chosen = i;
+                    break;
+                }
+            }
+        } else {
+            chosen = (int)((size_t)s->center_count * s->n / s->k);
+        }
+        memcpy(s->centers + (size_t)s->center_count * s->dims, s->points + (size_t)chosen * s->dims, s->dims * sizeof(double));
+    }
+}
+
+// zwraca liczbe punktow, ktore zmienily klaster. Przydzial z limitem: punkty o najwiekszej stracie wybieraja pierwsze; gdy waga reszty punktow ledwo
+// wystarcza na dopelnienie klastrow do min_size, punkt trafia do najblizszego niedopelnionego klastra
+static int capped_assignment(KMeansState *s, RegretEntry *order, int *sizes, long total, int min_size, int max_size, int *assignment) {
+    for (int i = 0; i < s->n; i++) {
+        order[i].index = i;
+        order[i].regret = s->regret[i];
+    }
+    qsort(order, s->n, sizeof(RegretEntry), cmp_regret);
+
+    memset(sizes, 0, s->k * sizeof(int));
+    long missing = (long)min_size * s->k;
+    long remaining = total;
+    int changed = 0;
+    for (int t = 0; t < s->n; t++) {
+        int i = order[t].index;
+        int w = point_weight(s, i);
+        int must_fill = remaining <= missing;
+        int best = -1;
+        double best_distance = DBL_MAX;
+        for (int c = 0; c < s->k; c++) {
+            if (sizes[c] + w > max_size) continue;
+            if (must_fill && sizes[c] >= min_size) continue;
+            double d = squared_distance(s->points + (size_t)i * s->dims, s->centers + (size_t)c * s->dims, s->dims);
+            if (d < best_distance) {
+                best_distance = d;
+                best = c;
+            }
+        }
+        if (best == -1) {
+            // limity nie do spelnienia (k * max_size < n) - najmniejszy klaster
+            best = 0;
+            for (int c = 1; c < s->k; c++) {
+                if (sizes[c] < sizes[best]) best = c;
+            }
+        }
+        if (sizes[best] < min_size) missing -= (min_size - sizes[best] < w) ? min_size - sizes[best] : w;
+        sizes[best] += w;
+        remaining -= w;
+        if (assignment[i] != best) changed++;
+        assignment[i] = best;
+    }
+    return changed;
+}
+
+void balanced_kmeans(const double *X, const int *weights, int n, int dims, int k, int min_size, int max_size, int *assignment) {
+    if (n <= 0 || k <= 0) return;
+    long total = 0;
+    for (int i = 0; i < n; i++) total += weights ? weights[i] : 1;
+    if (min_size < 0) min_size = 0;
+    if ((long)min_size * k > total) min_size = (int)(total / k);
+    if (max_size < min_size) max_size = min_size;
+
+    int blocks = (n + KMEANS_BLOCK - 1) / KMEANS_BLOCK;
+    KMeansState s;
+    s.n = n;
+    s.dims = dims;
+    s.k = k;
+    s.weights = weights;
+    double *points = malloc((size_t)n * dims * sizeof(double));
+    s.centers = malloc((size_t)k * dims * sizeof(double));
+    s.nearest = malloc(n * sizeof(double));
+    s.regret = malloc(n * sizeof(double));
+    s.block_sums = malloc((size_t)blocks * k * dims * sizeof(double));
+    RegretEntry *order = malloc(n * sizeof(RegretEntry));
+    int *sizes = malloc(k * sizeof(int));
+    if (!points || !s.centers || !s.nearest || !s.regret || !s.block_sums || !order || !sizes) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    // punkty wierszami - odleglosc do srodka czyta dims kolejnych liczb
+    for (int i = 0; i < n; i++) {
+        for (int d = 0; d < dims; d++) points[(size_t)i * dims + d] = X[(size_t)d * n + i];
+    }
+    s.points = points;
+    s.assignment = assignment;
+    for (int i = 0; i < n; i++) assignment[i] = -1;
+
+    seed_centers(&s, blocks);
+
+    for (int iter = 0; iter < KMEANS_MAX_ITER; iter++) {
+        parallel_for(blocks, distance_task, &s);
+        // przy ograniczonych rozmiarach pojedyncze punkty na granicy klastrow moga krazyc bez konca
+        int changed = capped_assignment(&s, order, sizes, total, min_size, max_size, assignment);
+        if (changed <= n * KMEANS_TOLERANCE) break;
+
+        // srodki z sum czesciowych blokow, sumowanych zawsze w tej samej kolejnosci
+        parallel_for(blocks, centroid_task, &s);
+        for (int c = 0; c < k; c++) {
+            if (sizes[c] == 0) continue;
+            for (int d = 0; d < dims; d++) {
+                double sum = 0;
+                for (int b = 0; b < blocks; b++) sum += s.block_sums[((size_t)b * k + c) * dims + d];
+                s.centers[(size_t)c * dims + d] = sum / sizes[c];
+            }
+        }
+    }
+
+    free(points);
+    free(s.centers);
+    free(s.nearest);
+    free(s.regret);
+    free(s.block_sums);
+    free(order);
+    free(sizes);
+}
@@ -0,0 +1,13 @@
+#ifndef KMEANS_H
+#define KMEANS_H
+
+#define KMEANS_MAX_ITER 50
+#define KMEANS_TOLERANCE 1e-3  // koniec, gdy klaster zmienia mniej niz ten ulamek punktow
+#define KMEANS_BLOCK 4096   // punkty na zadanie watku - sumy czesciowe blokow daja wynik niezalezny od liczby watkow
+
+// Zrownowazony k-means na punktach w R^dims (X kolumnami: wspolrzedna d punktu i pod X[d * n + i]).
+// Kazdy klaster dostaje punkty o lacznej wadze od min_size do max_size (o ile k * min_size <= suma wag <= k * max_size).
+// weights == NULL - wszystkie punkty waga 1 (rozmiar klastra to liczba punktow); srodki sa srednimi wazonymi.
+void balanced_kmeans(const double *X, const int *weights, int n, int dims, int k, int min_size, int max_size, int *assignment);
+
+#endif //KMEANS_H
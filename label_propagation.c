@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "graph_partition.h"
+#include "label_propagation.h"
+#include "geometric_method.h"
+#include "graph_utils.h"
+#include "thread_pool.h"
+
+typedef struct lp_job {
+    const Vertex *graph;
+    int vertex_count;
+    int parts;
+    int min_size;
+    int max_size;
+    atomic_int *labels;
+    atomic_int *sizes;
+    atomic_int moved;
+} LPJob;
+
+// rezerwacja miejsca: najpierw w grupie docelowej, potem zwolnienie zrodlowej; przy przekroczeniu okna cofamy
+static int try_move(LPJob *job, int from, int to, int weight) {
+    if (atomic_fetch_add_explicit(&job->sizes[to], weight, memory_order_relaxed) + weight > job->max_size) {
+        atomic_fetch_sub_explicit(&job->sizes[to], weight, memory_order_relaxed);
+        return 0;
+    }
+    if (atomic_fetch_sub_explicit(&job->sizes[from], weight, memory_order_relaxed) - weight < job->min_size) {
+        atomic_fetch_add_explicit(&job->sizes[from], weight, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&job->sizes[to], weight, memory_order_relaxed);
+        return 0;
+    }
+    return 1;
+}
+
+static void lp_block_task(int block, void *arg) {
+    LPJob *job = arg;
+    int *link = calloc(job->parts, sizeof(int));
+    int *touched = malloc(job->parts * sizeof(int));
+    if (!link || !touched) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    int moved = 0;
+    int last = (block + 1) * LP_BLOCK < job->vertex_count ? (block + 1) * LP_BLOCK : job->vertex_count;
+    for (int v = block * LP_BLOCK; v < last; v++) {
+        const Vertex *vertex = &job->graph[v];
+        int from = atomic_load_explicit(&job->labels[v], memory_order_relaxed);
+        int touched_count = 0;
+        for (int j = 0; j < vertex->edge_num; j++) {
+            int neighbor = vertex->conn[j];
+            if (neighbor == v) continue;
+            int g = atomic_load_explicit(&job->labels[neighbor], memory_order_relaxed);
+            if (link[g] == 0) touched[touched_count++] = g;
+            link[g] += edge_weight(vertex, j);
+        }
+
+        // najczestsza etykieta sasiadow; tylko scisly zysk, zeby etykiety nie oscylowaly
+        int best = from;
+        for (int t = 0; t < touched_count; t++) {
+            int g = touched[t];
+            if (link[g] > link[best] || (link[g] == link[best] && g < best && best != from)) best = g;
+        }
+        if (best != from && link[best] > link[from] && try_move(job, from, best, vertex->weight)) {
+            atomic_store_explicit(&job->labels[v], best, memory_order_relaxed);
+            moved++;
+        }
+
+        link[from] = 0;
+        for (int t = 0; t < touched_count; t++) link[touched[t]] = 0;
+    }
+
+    atomic_fetch_add(&job->moved, moved);
+    free(link);
+    free(touched);
+}
+
+void label_propagation(int parts, int vertex_count, double error_margin) {
+    hilbert_order_groups(parts, vertex_count);
+
+    int total_weight = 0;
+    for (int i = 0; i < vertex_count; i++) total_weight += vertices[i].weight;
+    int target = total_weight / parts;
+    int margin = (error_margin < 0) ? 0 : (int)(target * error_margin / 100.0);
+
+    LPJob job;
+    job.graph = vertices;
+    job.vertex_count = vertex_count;
+    job.parts = parts;
+    job.min_size = target - margin;
+    job.max_size = target + margin;
+    if (job.max_size * parts < total_weight) job.max_size = (total_weight + parts - 1) / parts;
+    job.labels = malloc(vertex_count * sizeof(atomic_int));
+    job.sizes = malloc(parts * sizeof(atomic_int));
+    if (!job.labels || !job.sizes) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    for (int g = 0; g < parts; g++) atomic_init(&job.sizes[g], 0);
+    for (int i = 0; i < vertex_count; i++) {
+        atomic_init(&job.labels[i], vertices[i].group);
+        atomic_fetch_add_explicit(&job.sizes[vertices[i].group], vertices[i].weight, memory_order_relaxed);
+    }
+
+    atomic_init(&job.moved, 0);
+    int blocks = (vertex_count + LP_BLOCK - 1) / LP_BLOCK;
+    for (int iter = 0; iter < LP_MAX_ITER; iter++) {
+        atomic_store(&job.moved, 0);
+        parallel_for(blocks, lp_block_task, &job);
+        if (atomic_load(&job.moved) <= vertex_count * LP_TOLERANCE) break;
+    }
+
+    for (int i = 0; i < vertex_count; i++) vertices[i].group = atomic_load_explicit(&job.labels[i], memory_order_relaxed);
+    free(job.labels);
+    free(job.sizes);
+
+    fix_group_connectivity(vertex_count, parts, job.min_size, job.max_size);
+}
@@ -0,0 +1,13 @@
+#ifndef LABEL_PROPAGATION_H
+#define LABEL_PROPAGATION_H
+
+#define LP_MAX_ITER 30
+#define LP_TOLERANCE 1e-3   // koniec, gdy w przebiegu zmienilo grupe mniej niz ten ulamek wierzcholkow
+#define LP_BLOCK 16384      // wierzcholki na zadanie watku
+
+// Propagacja etykiet z ograniczeniem rozmiaru: wierzcholek przechodzi do grupy, z ktora ma najwieksza wage krawedzi,
+// jesli licznik tej grupy (zmieniany atomowo) miesci sie w oknie error_margin. Przebiegi asynchroniczne - watki
+// widza juz zmienione etykiety, wiec przy wielu watkach wynik moze zalezec od ich liczby. Start z podzialu krzywa Hilberta.
+void label_propagation(int parts, int vertex_count, double error_margin);
+
+#endif //LABEL_PROPAGATION_H
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include "crypto/sha256.h"
+#include "line_index.h"
+
+static char *index_file_name(const char *input_file) {
+    char *name = malloc(strlen(input_file) + 5);
+    if (!name) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    sprintf(name, "%s.idx", input_file);
+    return name;
+}
+
+static void sample_hash(const char *data, size_t size, uint8_t hash[32]) {
+    SHA256_CTX sha256;
+    sha256_init(&sha256);
+
+    uint64_t size_le = size;
+    sha256_update(&sha256, (const BYTE *)&size_le, sizeof(size_le));
+
+    size_t head = size < LINE_INDEX_SAMPLE ? size : LINE_INDEX_SAMPLE;
+    sha256_update(&sha256, (const BYTE *)data, head);
+    sha256_update(&sha256, (const BYTE *)data + size - head, head);
+
+    sha256_final(&sha256, hash);
+}
+
+static void fill_header(LineIndexHeader *header, const struct stat *st, const char *data, size_t size, int line_count) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, LINE_INDEX_MAGIC, 4);
+    header->version = LINE_INDEX_VERSION;
+    header->file_size = size;
+    header->mtime_sec = st->st_mtim.tv_sec;
+    header->mtime_nsec = st->st_mtim.tv_nsec;
+    sample_hash(data, size, header->hash);
+    header->line_count = line_count;
+}
+
+int load_line_index(const char *input_file, const struct stat *st, const char *data, size_t size, const int *wanted, int count, const char **starts) {
+    char *name = index_file_name(input_file);
+    FILE *f = fopen(name, "rb");
+    free(name);
+    if (!f) return 0;
+
+    LineIndexHeader stored, expected;
+    if (fread(&stored, sizeof(stored), 1, f) != 1) {
+        fclose(f);
+        return 0;
+    }
+
+    // nieaktualny lub obcy indeks jest ignorowany i zostanie zbudowany od nowa
+    fill_header(&expected, st, data, size, (int)stored.line_count);
+    if (memcmp(&stored, &expected, sizeof(stored)) != 0 || stored.line_count == 0 || stored.line_count > size + 1) {
+        fclose(f);
+        return 0;
+    }
+
+    // tylko potrzebne wpisy; kazdy musi wskazywac poczatek linii (plik zmieniony w srodku przy tym samym rozmiarze
+    // i czasie modyfikacji daje inne polozenie znakow nowej linii)
+    int ok = 1;
+    for (int i = 0; ok && i < count; i++) {
+        uint64_t offset;
+        ok = wanted[i] >= 0 && (uint64_t)wanted[i] < stored.line_count &&
+             fseek(f, sizeof(stored) + (long)wanted[i] * sizeof(uint64_t), SEEK_SET) == 0 &&
+             fread(&offset, sizeof(offset), 1, f) == 1 && offset <= size && (offset == 0 || data[offset - 1] == '\n');
+        if (ok) starts[i] = data + offset;
+    }
+    fclose(f);
+    return ok ? (int)stored.line_count : 0;
+}
+
+void save_line_index(const char *input_file, const struct stat *st, const char *data, size_t size, const char **lines, int line_count) {
+    char *name = index_file_name(input_file);
+    FILE *f = fopen(name, "wb");
+    free(name);
+    // indeks jest opcjonalny - brak prawa zapisu nie przerywa programu
+    if (!f) return;
+
+    LineIndexHeader header;
+    fill_header(&header, st, data, size, line_count);
+    fwrite(&header, sizeof(header), 1, f);
+    for (int i = 0; i < line_count; i++) {
+        uint64_t offset = lines[i] - data;
+        fwrite(&offset, sizeof(offset), 1, f);
+    }
+    fclose(f);
+}
@@ -0,0 +1,28 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/stat.h>
+
+#define LINE_INDEX_MAGIC "CSRI"
+#define LINE_INDEX_VERSION 1
+#define LINE_INDEX_SAMPLE 65536
+
+// Plik <wejscie>.idx: naglowek + uint64 offset poczatku kazdej linii pliku .csrrg.
+// Skrot SHA-256 obejmuje rozmiar oraz poczatek i koniec pliku, wiec sprawdzenie aktualnosci jest O(1).
+typedef struct line_index_header {
+    char magic[4];
+    uint32_t version;
+    uint64_t file_size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    uint8_t hash[32];
+    uint64_t line_count;
+} LineIndexHeader;
+
+// Sprawdza naglowek i czyta tylko wpisy linii wanted[0..count) (fseek do naglowek + 8 * linia) do starts.
+// Zwraca liczbe linii pliku; 0 - brak indeksu, nieaktualny naglowek albo wpis nie wskazujacy poczatku linii.
+int load_line_index(const char *input_file, const struct stat *st, const char *data, size_t size, const int *wanted, int count, const char **starts);
+void save_line_index(const char *input_file, const struct stat *st, const char *data, size_t size, const char **lines, int line_count);
+
+#endif //LINE_INDEX_H
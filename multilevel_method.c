@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "graph_partition.h"
+#include "graph_utils.h"
+#include "spectral_method.h"
+#include "kmeans.h"
+#include "fm_method.h"
+#include "multilevel_method.h"
+
+Level coarsen_graph(Vertex *fine, int fine_count) {
+    Level level;
+    level.cmap = malloc(fine_count * sizeof(int));
+    int *match = malloc(fine_count * sizeof(int));
+    int *order = malloc(fine_count * sizeof(int));
+    int *degree_start = calloc(fine_count + 2, sizeof(int));
+    if (!level.cmap || !match || !order || !degree_start) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    // wierzcholki o malym stopniu dobieramy najpierw (sortowanie kubelkowe po stopniu - deterministyczne)
+    for (int v = 0; v < fine_count; v++) {
+        int d = fine[v].edge_num < fine_count ? fine[v].edge_num : fine_count;
+        degree_start[d + 1]++;
+    }
+    for (int d = 0; d <= fine_count; d++) degree_start[d + 1] += degree_start[d];
+    for (int v = 0; v < fine_count; v++) {
+        int d = fine[v].edge_num < fine_count ? fine[v].edge_num : fine_count;
+        order[degree_start[d]++] = v;
+    }
+    free(degree_start);
+
+    // dopasowanie po najciezszej krawedzi
+    for (int v = 0; v < fine_count; v++) match[v] = -1;
+    int coarse_count = 0;
+    for (int k = 0; k < fine_count; k++) {
+        int v = order[k];
+        if (match[v] != -1) continue;
+
+        int best = v, best_weight = 0;
+        for (int j = 0; j < fine[v].edge_num; j++) {
+            int u = fine[v].conn[j];
+            int w = edge_weight(&fine[v], j);
+            if (u == v || match[u] != -1) continue;
+            if (w > best_weight || (w == best_weight && best != v && fine[u].weight < fine[best].weight)) {
+                best = u;
+                best_weight = w;
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+        level.cmap[v] = level.cmap[best] = coarse_count++;
+    }
+    free(order);
+
+    level.vertex_count = coarse_count;
+    level.verts = malloc(coarse_count * sizeof(Vertex));
+    int *first = malloc(coarse_count * sizeof(int));
+    if (!level.verts || !first) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    size_t bound = 0;
+    for (int v = 0; v < fine_count; v++) bound += fine[v].edge_num;
+    level.adj = malloc((bound + 1) * sizeof(int));
+    level.adj_weights = malloc((bound + 1) * sizeof(int));
+    int *slot = malloc(coarse_count * sizeof(int));
+    if (!level.adj || !level.adj_weights || !slot) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    for (int v = fine_count - 1; v >= 0; v--) first[level.cmap[v]] = v < match[v] ? v : match[v];
+    for (int c = 0; c < coarse_count; c++) slot[c] = -1;
+
+    // scalanie list sasiadow obu wierzcholkow pary; slot[] pamieta pozycje sasiada w biezacym wierszu
+    int write = 0;
+    for (int c = 0; c < coarse_count; c++) {
+        int a = first[c];
+        int b = match[a];
+        int begin = write;
+
+        Vertex *cv = &level.verts[c];
+        cv->x = fine[a].x;
+        cv->y = fine[a].y;
+        cv->group = 0;
+        cv->fixed = 0;
+        cv->processed = 0;
+        cv->D = 0;
+        cv->weight = fine[a].weight + (b != a ? fine[b].weight : 0);
+
+        for (int m = 0; m < (b != a ? 2 : 1); m++) {
+            int v = m == 0 ? a : b;
+            for (int j = 0; j < fine[v].edge_num; j++) {
+                int target = level.cmap[fine[v].conn[j]];
+                if (target == c) continue;
+                if (slot[target] == -1) {
+                    slot[target] = write;
+                    level.adj[write] = target;
+                    level.adj_weights[write++] = edge_weight(&fine[v], j);
+                } else {
+                    level.adj_weights[slot[target]] += edge_weight(&fine[v], j);
+                }
+            }
+        }
+        for (int k = begin; k < write; k++) slot[level.adj[k]] = -1;
+
+        cv->edge_num = write - begin;
+        first[c] = begin;
+    }
+
+    for (int c = 0; c < coarse_count; c++) {
+        level.verts[c].conn = level.adj + first[c];
+        level.verts[c].weights = level.adj_weights + first[c];
+    }
+
+    free(slot);
+    free(first);
+    free(match);
+    return level;
+}
+
+void free_level(Level *level) {
+    free(level->verts);
+    free(level->adj);
+    free(level->adj_weights);
+    free(level->cmap);
+}
+
+// podzial najmniejszego grafu z granicami na sume wag: 2 grupy - ciecie wzdluz wektora Fiedlera poprawione FM,
+// wiecej grup - zrownowazony k-means na k wektorach wlasnych. Wektory liczone bez --eigen-cache (graf zgrubny nie jest
+// grafem wejsciowym), a spojnosc i rownowage grup sprawdza dopiero podzial na grafie wejsciowym
+static void partition_coarsest(int parts, int vertex_count, int min_weight, int max_weight) {
+    double *X = malloc((size_t)parts * vertex_count * sizeof(double));
+    if (!X) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+
+    if (parts == 2) {
+        Entry *entries = malloc(vertex_count * sizeof(Entry));
+        if (!entries) {
+            printf("Blad pamieci.\n");
+            exit(15);
+        }
+        compute_embedding(vertex_count, 1, X, 0);
+        for (int i = 0; i < vertex_count; i++) {
+            entries[i].index = i;
+            entries[i].value = X[i];
+        }
+        qsort(entries, vertex_count, sizeof(Entry), cmp_entry);
+        sweep_cut(entries, vertex_count, min_weight, max_weight);
+        fiduccia_mattheyses(vertex_count, min_weight, max_weight);
+        free(entries);
+    } else {
+        int *weights = malloc(vertex_count * sizeof(int));
+        int *assignment = malloc(vertex_count * sizeof(int));
+        if (!weights || !assignment) {
+            printf("Blad pamieci.\n");
+            exit(15);
+        }
+        compute_embedding(vertex_count, parts, X, 0);
+        for (int i = 0; i < vertex_count; i++) weights[i] = vertices[i].weight;
+        balanced_kmeans(X, weights, vertex_count, parts, parts, min_weight, max_weight, assignment);
+        for (int i = 0; i < vertex_count; i++) vertices[i].group = assignment[i];
+        free(weights);
+        free(assignment);
+    }
+    free(X);
+}
+
+void multilevel_partitioning(int parts, int vertex_count, double error_margin) {
+    Level levels[MAX_LEVELS];
+    int level_count = 0;
+
+    int coarsest = COARSEST_VERTICES_PER_PART * parts;
+    if (coarsest < COARSEST_MIN_VERTICES) coarsest = COARSEST_MIN_VERTICES;
+
+    // 1. zgrubianie - kolejne dopasowania po najciezszych krawedziach
+    Vertex *current = vertices;
+    int current_count = vertex_count;
+    while (current_count > coarsest && level_count < MAX_LEVELS) {
+        Level next = coarsen_graph(current, current_count);
+        if (next.vertex_count > current_count * 0.95) {
+            free_level(&next);
+            break;
+        }
+        levels[level_count++] = next;
+        current = next.verts;
+        current_count = next.vertex_count;
+    }
+
+    int ideal = vertex_count / parts;
+    int slack = (int)(ideal * error_margin / 100.0);
+    int min_weight = ideal - slack;
+    int max_weight = ideal + slack;
+    if (max_weight * parts < vertex_count) max_weight = (vertex_count + parts - 1) / parts;
+
+    // 2. podzial najmniejszego grafu
+    Vertex *fine_vertices = vertices;
+    vertices = current;
+    partition_coarsest(parts, current_count, min_weight, max_weight);
+    refine_boundary_weighted(current_count, parts, min_weight, max_weight);
+
+    // 3. rzutowanie w gore z poprawa brzegu na kazdym poziomie
+    for (int l = level_count - 1; l >= 0; l--) {
+        Vertex *finer = l > 0 ? levels[l - 1].verts : fine_vertices;
+        int finer_count = l > 0 ? levels[l - 1].vertex_count : vertex_count;
+        for (int v = 0; v < finer_count; v++) {
+            finer[v].group = levels[l].verts[levels[l].cmap[v]].group;
+        }
+
+        vertices = finer;
+        refine_boundary_weighted(finer_count, parts, min_weight, max_weight);
+        free_level(&levels[l]);
+    }
+    vertices = fine_vertices;
+
+    fix_group_connectivity(vertex_count, parts, min_weight, max_weight);
+}
@@ -0,0 +1,22 @@
+#ifndef MULTILEVEL_METHOD_H
+#define MULTILEVEL_METHOD_H
+#include "graph_partition.h"
+
+#define COARSEST_MIN_VERTICES 100
+#define COARSEST_VERTICES_PER_PART 30
+#define MAX_LEVELS 40
+
+// Jeden poziom hierarchii: graf zgrubny z wagami oraz odwzorowanie wierzcholkow poziomu drobniejszego
+typedef struct level {
+    int vertex_count;
+    Vertex *verts;
+    int *adj;
+    int *adj_weights;
+    int *cmap;
+} Level;
+
+Level coarsen_graph(Vertex *fine, int fine_count);
+void free_level(Level *level);
+void multilevel_partitioning(int parts, int vertex_count, double error_margin);
+
+#endif //MULTILEVEL_METHOD_H
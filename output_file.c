@@ -67,6 +67,15 @@ int validate_checksum(const char *filename) {
     return stored_checksum == computed_checksum;
 }
 
+int needs_wide_ids(int vertex_count) {
+    if (vertex_count > UINT16_MAX) return 1;
+    for (int i = 0; i < vertex_count; i++) {
+        if (vertices[i].x > UINT16_MAX || vertices[i].y > UINT16_MAX ||
+            vertices[i].group > UINT16_MAX || vertices[i].edge_num > UINT16_MAX) return 1;
+    }
+    return 0;
+}
+
 void write_binary_output(const char *filename, int vertex_count) {
     uint32_t file_id = generate_file_id_from_graph();
 
@@ -76,20 +85,32 @@ void write_binary_output(const char *filename, int vertex_count) {
         exit(14);
     }
 
-    uint8_t endian_byte = 0x01;
-    fwrite(&endian_byte, 1, 1, f);
+    // 16-bitowy uklad zostaje dla malych grafow, wieksze nigdy nie sa obcinane
+    int wide = wide_flag || needs_wide_ids(vertex_count);
+    uint8_t flags_byte = OUTPUT_FLAG_LITTLE_ENDIAN | (wide ? OUTPUT_FLAG_WIDE_IDS : 0);
+    fwrite(&flags_byte, 1, 1, f);
     write_uint32_le(f, file_id);
     write_uint32_le(f, 0);
 
     long data_offset = ftell(f);
 
     for (int i = 0; i < vertex_count; i++) {
-        write_uint16_le(f, (uint16_t)vertices[i].x);
-        write_uint16_le(f, (uint16_t)vertices[i].y);
-        write_uint16_le(f, (uint16_t)vertices[i].group);
-        write_uint16_le(f, (uint16_t)vertices[i].edge_num);
-        for (int j = 0; j < vertices[i].edge_num; j++) {
-            write_uint16_le(f, (uint16_t)vertices[i].conn[j]);
+        if (wide) {
+            write_uint32_le(f, (uint32_t)vertices[i].x);
+            write_uint32_le(f, (uint32_t)vertices[i].y);
+            write_uint32_le(f, (uint32_t)vertices[i].group);
+            write_uint32_le(f, (uint32_t)vertices[i].edge_num);
+            for (int j = 0; j < vertices[i].edge_num; j++) {
+                write_uint32_le(f, (uint32_t)vertices[i].conn[j]);
+            }
+        } else {
+            write_uint16_le(f, (uint16_t)vertices[i].x);
+            write_uint16_le(f, (uint16_t)vertices[i].y);
+            write_uint16_le(f, (uint16_t)vertices[i].group);
+            write_uint16_le(f, (uint16_t)vertices[i].edge_num);
+            for (int j = 0; j < vertices[i].edge_num; j++) {
+                write_uint16_le(f, (uint16_t)vertices[i].conn[j]);
+            }
         }
     }
 
@@ -127,4 +148,24 @@ void write_ascii_output(const char *filename, int vertex_count) {
     }
 
     fclose(f);
-}
\ No newline at end of file
+}
+
+void write_stream_header(FILE *f, int binary, int vertex_count, int parts) {
+    if (binary) {
+        uint8_t flags_byte = OUTPUT_FLAG_LITTLE_ENDIAN | OUTPUT_FLAG_STREAM;
+        fwrite(&flags_byte, 1, 1, f);
+        write_uint32_le(f, (uint32_t)vertex_count);
+        write_uint32_le(f, (uint32_t)parts);
+    } else {
+        fprintf(f, "%d\n%d\n", vertex_count, parts);
+    }
+}
+
+void write_stream_assignment(FILE *f, int binary, int vertex, int group) {
+    if (binary) {
+        write_uint32_le(f, (uint32_t)vertex);
+        write_uint32_le(f, (uint32_t)group);
+    } else {
+        fprintf(f, "%d;%d\n", vertex, group);
+    }
+}
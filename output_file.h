@@ -3,13 +3,22 @@
 #include <stdint.h>
 #include <stdio.h>
 
+// bajt flag na poczatku pliku binarnego; bez OUTPUT_FLAG_WIDE_IDS pola maja 16 bitow (wersja 1), z nia 32 bity (wersja 2)
+#define OUTPUT_FLAG_LITTLE_ENDIAN 0x01
+#define OUTPUT_FLAG_WIDE_IDS 0x02
+// wynik trybu strumieniowego: po naglowku (liczba wierzcholkow, liczba grup) tylko pary (wierzcholek, grupa) uint32
+#define OUTPUT_FLAG_STREAM 0x04
+
 static void write_uint16_le(FILE *f, uint16_t val);
 static void write_uint32_le(FILE *f, uint32_t val);
 static uint32_t calculate_sha256_checksum(const char *filename, long data_offset);
 static uint32_t generate_file_id_from_graph();
 int validate_checksum(const char *filename);
+int needs_wide_ids(int vertex_count);
 void write_binary_output(const char *filename, int vertex_count);
 void write_ascii_output(const char *filename, int vertex_count);
+void write_stream_header(FILE *f, int binary, int vertex_count, int parts);
+void write_stream_assignment(FILE *f, int binary, int vertex, int group);
 
 
 #endif //OUTPUT_FILE_H
\ No newline at end of file
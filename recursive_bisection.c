@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "graph_partition.h"
+#include "recursive_bisection.h"
+#include "kl_method.h"
+#include "fm_method.h"
+#include "graph_utils.h"
+#include "thread_pool.h"
+
+typedef struct bisection_task {
+    const char *method;
+    Subgraph graph;
+    int parts;
+    int first_group;
+    double error_margin;
+} BisectionTask;
+
+static void bisection_task(int index, void *arg);
+
+// dwudzielny podzial biezacego grafu: grupa 0 ma od min_group do max_group wierzcholkow
+static void bisect(const char *method, int vertex_count, int min_group, int max_group) {
+    if (strcmp(method, "fm") == 0) {
+        initial_bipartition(vertex_count, (min_group + max_group) / 2);
+        fiduccia_mattheyses(vertex_count, min_group, max_group);
+        return;
+    }
+
+    int *best_groups = malloc(vertex_count * sizeof(int));
+    if (!best_groups) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    if (kl_size_sweep(vertex_count, min_group, max_group, best_groups) != INT_MAX) {
+        for (int i = 0; i < vertex_count; i++) vertices[i].group = best_groups[i];
+    } else {
+        initial_bipartition(vertex_count, min_group);
+    }
+    free(best_groups);
+}
+
+static Subgraph extract_side(const Vertex *graph, int vertex_count, int side) {
+    Subgraph sub;
+    int *local = malloc(vertex_count * sizeof(int));
+    if (!local) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    // numeracja w podgrafie zachowuje kolejnosc wierzcholkow (kandydat startowy KL "po indeksach")
+    int count = 0;
+    size_t entries = 0;
+    int weighted = 0;
+    for (int i = 0; i < vertex_count; i++) {
+        if (graph[i].group != side) continue;
+        local[i] = count++;
+        for (int j = 0; j < graph[i].edge_num; j++) {
+            if (graph[graph[i].conn[j]].group == side) entries++;
+        }
+        if (graph[i].weights) weighted = 1;
+    }
+
+    sub.vertex_count = count;
+    sub.verts = malloc((count ? count : 1) * sizeof(Vertex));
+    sub.map = malloc((count ? count : 1) * sizeof(int));
+    sub.adj = malloc((entries ? entries : 1) * sizeof(int));
+    sub.adj_weights = weighted ? malloc((entries ? entries : 1) * sizeof(int)) : NULL;
+    if (!sub.verts || !sub.map || !sub.adj || (weighted && !sub.adj_weights)) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    size_t pos = 0;
+    for (int i = 0; i < vertex_count; i++) {
+        if (graph[i].group != side) continue;
+        Vertex *v = &sub.verts[local[i]];
+        *v = graph[i];
+        v->conn = sub.adj + pos;
+        v->weights = weighted ? sub.adj_weights + pos : NULL;
+        v->edge_num = 0;
+        v->group = 0;
+        v->fixed = 0;
+        v->processed = 0;
+        for (int j = 0; j < graph[i].edge_num; j++) {
+            int neighbor = graph[i].conn[j];
+            if (graph[neighbor].group != side) continue;
+            v->conn[v->edge_num] = local[neighbor];
+            if (weighted) v->weights[v->edge_num] = edge_weight(&graph[i], j);
+            v->edge_num++;
+        }
+        pos += v->edge_num;
+        sub.map[local[i]] = i;
+    }
+
+    free(local);
+    return sub;
+}
+
+static void free_subgraph(Subgraph *sub) {
+    free(sub->verts);
+    free(sub->adj);
+    free(sub->adj_weights);
+    free(sub->map);
+}
+
+// dzieli task->graph na task->parts grup numerowanych od task->first_group
+static void bisect_recursive(BisectionTask *task) {
+    Vertex *graph = task->graph.verts;
+    int n = task->graph.vertex_count;
+    if (task->parts == 1 || n < 2) {
+        for (int i = 0; i < n; i++) graph[i].group = task->first_group;
+        return;
+    }
+
+    // niepotegi dwojki: strona 0 dostaje floor(k/2) grup i proporcjonalna czesc wierzcholkow
+    int left_parts = task->parts / 2;
+    int target = (int)((long)n * left_parts / task->parts);
+    int slack = (int)((double)n / task->parts * task->error_margin / 100.0);
+    if (task->error_margin < 0) slack = 0;
+    int min_group = target - slack < 1 ? 1 : target - slack;
+    int max_group = target + slack > n - 1 ? n - 1 : target + slack;
+
+    Vertex *saved = vertices;
+    vertices = graph;
+    bisect(task->method, n, min_group, max_group);
+    vertices = saved;
+
+    BisectionTask children[2];
+    for (int side = 0; side < 2; side++) {
+        children[side].method = task->method;
+        children[side].graph = extract_side(graph, n, side);
+        children[side].parts = side == 0 ? left_parts : task->parts - left_parts;
+        children[side].first_group = task->first_group + (side == 0 ? 0 : left_parts);
+        children[side].error_margin = task->error_margin;
+    }
+
+    // poddrzewa nie wspoldziela danych - kazde na wlasnym podgrafie; wywolanie zagniezdzone trafia do wspolnej puli,
+    // wiec rownolegle ida wszystkie poziomy drzewa (i przeglad rozmiarow KL w kazdym wezle), nie tylko korzen
+    parallel_for(2, bisection_task, children);
+
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < children[side].graph.vertex_count; i++) {
+            graph[children[side].graph.map[i]].group = children[side].graph.verts[i].group;
+        }
+        free_subgraph(&children[side].graph);
+    }
+}
+
+static void bisection_task(int index, void *arg) {
+    BisectionTask *task = (BisectionTask *)arg + index;
+    bisect_recursive(task);
+}
+
+void recursive_bisection(const char *method, int parts, int vertex_count, double error_margin) {
+    BisectionTask root;
+    root.method = method;
+    root.graph.vertex_count = vertex_count;
+    root.graph.verts = vertices;
+    root.parts = parts;
+    root.first_group = 0;
+    root.error_margin = error_margin;
+    bisect_recursive(&root);
+
+    int target = vertex_count / parts;
+    int margin = (error_margin < 0) ? 0 : (int)(target * error_margin / 100.0);
+    int max_size = target + margin;
+    if (max_size * parts < vertex_count) max_size = (vertex_count + parts - 1) / parts;
+    fix_group_connectivity(vertex_count, parts, target - margin, max_size);
+}
@@ -0,0 +1,18 @@
+#ifndef RECURSIVE_BISECTION_H
+#define RECURSIVE_BISECTION_H
+#include "graph_partition.h"
+
+// podgraf indukowany jednej strony podzialu - wlasne tablice CSR, map[i] to numer wierzcholka w grafie nadrzednym
+typedef struct subgraph {
+    int vertex_count;
+    Vertex *verts;
+    int *adj;
+    int *adj_weights;
+    int *map;
+} Subgraph;
+
+// Podzial na dowolna liczbe grup metoda dwudzielna (kl lub fm): graf dzielony jest w proporcji
+// floor(k/2) : ceil(k/2), a obie strony rekurencyjnie i rownolegle jako osobne podgrafy.
+void recursive_bisection(const char *method, int parts, int vertex_count, double error_margin);
+
+#endif //RECURSIVE_BISECTION_H
@@ -4,6 +4,7 @@
 #include <getopt.h>
 #include <math.h>
 #include <stdint.h>
+#include <limits.h>
 #include <gsl/gsl_eigen.h>
 #include <gsl/gsl_matrix.h>
 #include <gsl/gsl_vector.h>
@@ -11,6 +12,10 @@
 #include "graph_partition.h"
 #include "spectral_method.h"
 #include "graph_utils.h"
+#include "eigen_solver.h"
+#include "multilevel_method.h"
+#include "kmeans.h"
+#include "eigen_cache.h"
 
 #define EPSILON 1e-6
 
@@ -52,41 +57,38 @@ void free_matrix(Matrix *m) {
 Matrix *build_laplacian_matrix(int n) {
     Matrix *L = alloc_matrix(n);
     for (int i = 0; i < n; i++) {
-        int deg = vertices[i].edge_num;
-        L->data[i][i] = deg;
-        for (int j = 0; j < deg; j++) {
+        for (int j = 0; j < vertices[i].edge_num; j++) {
             int neighbor = vertices[i].conn[j];
-            L->data[i][neighbor] = -1;
+            if (neighbor == i) continue;
+            L->data[i][i] += edge_weight(&vertices[i], j);
+            L->data[i][neighbor] = -edge_weight(&vertices[i], j);
         }
     }
     return L;
 }
 
 void normalize_vector(double *v, int n) {
-    double norm = 0;
-    for (int i = 0; i < n; i++) norm += v[i] * v[i];
-    norm = sqrt(norm);
+    double norm = sqrt(dot_product(v, v, n));
     if (norm > EPSILON) {
-        for (int i = 0; i < n; i++) v[i] /= norm;
+        scale_vector(v, 1.0 / norm, n);
     }
 }
 
-void matvec_mul(Matrix *m, double *v, double *result) {
-    for (int i = 0; i < m->n; i++) {
-        result[i] = 0;
-        for (int j = 0; j < m->n; j++) {
-            result[i] += m->data[i][j] * v[j];
-        }
+// mnozenie przez rzadki Laplacjan - jadra SIMD/wielowatkowe z spmv.c
+void matvec_mul(const SparseMatrix *m, const double *v, double *result) {
+    if (m->sell != NULL) {
+        sell_spmv(m->sell, v, result);
+    } else {
+        csr_spmv(m->n, m->row_start, m->col, m->val, v, result);
     }
 }
 
 double vector_dot(const double *a, const double *b, int n) {
-    double sum = 0;
-    for (int i = 0; i < n; i++) sum += a[i] * b[i];
-    return sum;
+    return dot_product(a, b, n);
 }
 
-void power_iteration(Matrix *L, double *eigenvector, const int max_iter) {
+// k najmniejszych nietrywialnych wektorow wlasnych (kolumnami w X) - pomijamy najmniejszy, czyli wektor staly
+void dense_eigenvectors(Matrix *L, int k, double *X) {
     const int n = L->n;
 
     // GSL Matrix i Vector
@@ -108,24 +110,16 @@ void power_iteration(Matrix *L, double *eigenvector, const int max_iter) {
         printf("Blad podczas obliczania wartości i wektorów własnych.\n");
         exit(19);
     }
+    gsl_eigen_symmv_sort(eigenvalues, eigenvectors, GSL_EIGEN_SORT_VAL_ASC);
 
-    // Wybieramy drugi najmniejszy wektor własny (Fiedler vector)
-    double min_value = gsl_vector_get(eigenvalues, 0);
-    int min_index = 0;
-    for (int i = 1; i < n; i++) {
-        double val = gsl_vector_get(eigenvalues, i);
-        if (val > min_value) {
-            min_value = val;
-            min_index = i;
+    // Kopiowanie wektorów 1..k (0 to wektor staly); dla malych grafow brakujace kolumny zostaja zerowe
+    for (int c = 0; c < k; c++) {
+        int column = (c + 1 < n) ? c + 1 : -1;
+        for (int i = 0; i < n; i++) {
+            X[(size_t)c * n + i] = (column == -1) ? 0 : gsl_matrix_get(eigenvectors, i, column);
         }
     }
 
-    // Kopiowanie drugiego najmniejszego wektora własnego
-    gsl_vector_view vec = gsl_matrix_column(eigenvectors, min_index);
-    for (int i = 0; i < n; i++) {
-        eigenvector[i] = gsl_vector_get(&vec.vector, i);
-    }
-
     // Zwolnij pamięć
     gsl_eigen_symmv_free(workspace);
     gsl_matrix_free(gsl_L);
@@ -133,30 +127,189 @@ void power_iteration(Matrix *L, double *eigenvector, const int max_iter) {
     gsl_matrix_free(eigenvectors);
 }
 
-int edge_cut_all(int vertex_count) {
-    int cut = 0;
-    for (int i = 0; i < vertex_count; i++) {
+SparseMatrix *build_sparse_laplacian(int n) {
+    SparseMatrix *L = malloc(sizeof(SparseMatrix));
+    if (!L) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    L->n = n;
+    L->row_start = malloc((n + 1) * sizeof(int));
+    size_t nnz = n;
+    for (int i = 0; i < n; i++) nnz += vertices[i].edge_num;
+    L->col = malloc(nnz * sizeof(int));
+    L->val = malloc(nnz * sizeof(double));
+    if (!L->row_start || !L->col || !L->val) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        L->row_start[i] = k;
+        int diagonal = k++;
+        L->col[diagonal] = i;
+        L->val[diagonal] = 0;
         for (int j = 0; j < vertices[i].edge_num; j++) {
             int neighbor = vertices[i].conn[j];
-            if (vertices[i].group != vertices[neighbor].group) cut++;
+            if (neighbor == i) continue;
+            L->col[k] = neighbor;
+            L->val[k++] = -edge_weight(&vertices[i], j);
+            L->val[diagonal] += edge_weight(&vertices[i], j);
+        }
+    }
+    L->row_start[n] = k;
+    L->sell = build_sell_matrix(n, L->row_start, L->col, L->val);
+    return L;
+}
+
+void free_sparse_matrix(SparseMatrix *m) {
+    if (m->sell) free_sell_matrix(m->sell);
+    free(m->row_start);
+    free(m->col);
+    free(m->val);
+    free(m);
+}
+
+// warm_start - X zawiera juz przyblizenie (np. z cache), wtedy pomijamy rozwiazanie na grafie zgrubnym
+void compute_embedding(int vertex_count, int k, double *X, int warm_start) {
+    if (vertex_count <= DENSE_EIGEN_LIMIT || 3 * k >= vertex_count) {
+        Matrix *L = build_laplacian_matrix(vertex_count);
+        dense_eigenvectors(L, k, X);
+        free_matrix(L);
+        return;
+    }
+
+    // start z wektorow grafu zgrubnego (dopasowanie jak w metodzie ml) - LOBPCG potrzebuje wtedy niewielu iteracji
+    Level level = warm_start ? (Level){ 0 } : coarsen_graph(vertices, vertex_count);
+    if (!warm_start && level.vertex_count < vertex_count * 0.95) {
+        double *coarse = malloc((size_t)k * level.vertex_count * sizeof(double));
+        if (!coarse) {
+            printf("Blad pamieci.");
+            exit(15);
+        }
+        Vertex *fine = vertices;
+        vertices = level.verts;
+        compute_embedding(level.vertex_count, k, coarse, 0);
+        vertices = fine;
+
+        for (int c = 0; c < k; c++) {
+            for (int i = 0; i < vertex_count; i++) {
+                X[(size_t)c * vertex_count + i] = coarse[(size_t)c * level.vertex_count + level.cmap[i]];
+            }
+        }
+        free(coarse);
+        warm_start = 1;
+    }
+    free_level(&level);
+
+    // rzadka sciezka: pamiec O(k (V + E)), tylko k wektorow wlasnych zamiast pelnego rozkladu
+    SparseMatrix *L = build_sparse_laplacian(vertex_count);
+    double *values = malloc(k * sizeof(double));
+    if (!values) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    lobpcg_smallest(L, k, X, values, warm_start, LOBPCG_TOLERANCE, LOBPCG_MAX_ITER);
+    free(values);
+    free_sparse_matrix(L);
+}
+
+// wektory z --eigen-cache: ten sam graf - bez liczenia, podobny graf - tylko jako punkt startowy LOBPCG
+void spectral_embedding(int vertex_count, int k, double *X) {
+    int cached = load_eigenvectors(vertex_count, k, X);
+    if (cached == 2) return;
+    compute_embedding(vertex_count, k, X, cached == 1);
+    save_eigenvectors(vertex_count, k, X);
+}
+
+void fiedler_vector(int vertex_count, double *eigenvector) {
+    spectral_embedding(vertex_count, 1, eigenvector);
+}
+
+// podzial na k czesci: wierzcholki zanurzone w R^k przez k wektorow wlasnych, grupy z zrownowazonego k-means
+static void kway_spectral_partitioning(int parts, int vertex_count, double error_margin) {
+    int dims = parts;
+    double *embedding = malloc((size_t)dims * vertex_count * sizeof(double));
+    int *assignment = malloc(vertex_count * sizeof(int));
+    if (embedding == NULL || assignment == NULL) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    spectral_embedding(vertex_count, dims, embedding);
+
+    int target = vertex_count / parts;
+    int margin = (int)(target * error_margin / 100.0);
+    int min_size = target - margin;
+    if (min_size < 0) min_size = 0;
+    int max_size = target + margin;
+    // reszta z dzielenia musi sie gdzies zmiescic
+    if ((long)max_size * parts < vertex_count) max_size = (vertex_count + parts - 1) / parts;
+
+    balanced_kmeans(embedding, NULL, vertex_count, dims, parts, min_size, max_size, assignment);
+    for (int i = 0; i < vertex_count; i++) vertices[i].group = assignment[i];
+
+    refine_boundary_weighted(vertex_count, parts, min_size, max_size);
+    fix_group_connectivity(vertex_count, parts, min_size, max_size);
+
+    free(embedding);
+    free(assignment);
+}
+
+// przesuwamy wierzcholki w kolejnosci wektora Fiedlera z grupy 1 do 0, przekroj aktualizowany o wagi krawedzi
+// przenoszonego wierzcholka - O(V + E) na wszystkie punkty podzialu; wybieramy najmniejszy przekroj w oknie rozmiarow.
+// Rozmiar grupy 0 to suma wag wierzcholkow (na grafie wejsciowym wagi sa rowne 1)
+int sweep_cut(const Entry *entries, int vertex_count, int min_size, int max_size) {
+    long total = 0;
+    for (int i = 0; i < vertex_count; i++) {
+        vertices[i].group = 1;
+        total += vertices[i].weight;
+    }
+
+    long cut = 0;
+    long best_cut = LONG_MAX;
+    int best_prefix = vertex_count / 2;
+    long best_weight = total;
+    long half = total / 2;
+    long weight = 0;
+    for (int p = 1; p < vertex_count; p++) {
+        int v = entries[p - 1].index;
+        for (int j = 0; j < vertices[v].edge_num; j++) {
+            int neighbor = vertices[v].conn[j];
+            if (neighbor == v) continue;
+            cut += (vertices[neighbor].group == 1) ? edge_weight(&vertices[v], j) : -edge_weight(&vertices[v], j);
+        }
+        vertices[v].group = 0;
+        weight += vertices[v].weight;
+
+        if (weight < min_size || weight > max_size) continue;
+        // przy rownym przekroju wygrywa podzial blizszy polowie
+        if (cut < best_cut || (cut == best_cut && labs(weight - half) < labs(best_weight - half))) {
+            best_cut = cut;
+            best_prefix = p;
+            best_weight = weight;
         }
     }
-    return cut / 2;
+
+    for (int p = 0; p < vertex_count; p++) vertices[entries[p].index].group = (p < best_prefix) ? 0 : 1;
+    return best_prefix;
 }
 
 void spectral_partitioning(int parts, int vertex_count, double error_margin) {
-    Matrix *L = build_laplacian_matrix(vertex_count);
+    if (parts > 2) {
+        kway_spectral_partitioning(parts, vertex_count, error_margin);
+        return;
+    }
+
     double *eigenvector = malloc(vertex_count * sizeof(double));
     Entry *entries = malloc(vertex_count * sizeof(Entry));
-    int *best_groups = malloc(vertex_count * sizeof(int));
-
-    if (eigenvector == NULL || entries == NULL || best_groups == NULL) {
+    if (eigenvector == NULL || entries == NULL) {
         printf("Blad pamieci.");
         exit(15);
     }
 
-    int max_iter = vertex_count * 10;
-    power_iteration(L, eigenvector, max_iter);
+    fiedler_vector(vertex_count, eigenvector);
 
     for (int i = 0; i < vertex_count; i++) {
         entries[i].index = i;
@@ -164,39 +317,17 @@ void spectral_partitioning(int parts, int vertex_count, double error_margin) {
     }
     qsort(entries, vertex_count, sizeof(Entry), cmp_entry);
 
-    int best_edge_cut = 999999;
-
-    for (int start = 0; start < parts; start++) {
-        int *group_counts = calloc(parts, sizeof(int));
-        if(group_counts == NULL) {
-            printf("Blad pamieci");
-            exit(15);
-        }
-        for (int i = 0; i < vertex_count; i++) {
-            int g = i % parts;
-            vertices[entries[i].index].group = g;
-            group_counts[g]++;
-        }
+    int target = vertex_count / parts;
+    int margin = (int)(target * error_margin / 100.0);
+    int min_size = target - margin;
+    if (min_size < 0) min_size = 0;
+    int max_size = target + margin;
 
-        int target = vertex_count / parts;
-        int margin = (int)(target * error_margin / 100.0);
-        int min_size = target - margin;
-        if (min_size < 0) min_size = 0;
-        int max_size = target + margin;
-
-        fix_group_connectivity(vertex_count, parts, min_size, max_size);
-        int edge_cut = edge_cut_all(vertex_count);
-        if (edge_cut < best_edge_cut) {
-            best_edge_cut = edge_cut;
-            for (int i = 0; i < vertex_count; i++) best_groups[i] = vertices[i].group;
-        }
-        free(group_counts);
-    }
+    sweep_cut(entries, vertex_count, min_size, max_size);
 
-    for (int i = 0; i < vertex_count; i++) vertices[i].group = best_groups[i];
+    refine_boundary_weighted(vertex_count, parts, min_size, max_size);
+    fix_group_connectivity(vertex_count, parts, min_size, max_size);
 
-    free(best_groups);
-    free_matrix(L);
     free(eigenvector);
     free(entries);
 }
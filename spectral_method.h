@@ -1,11 +1,24 @@
 #ifndef SPECTRAL_METHOD_H
 #define SPECTRAL_METHOD_H
+#include "spmv.h"
+
+// do tego rozmiaru wektor Fiedlera liczy gesty solver GSL, powyzej rzadki LOBPCG
+#define DENSE_EIGEN_LIMIT 200
 
 typedef struct matrix {
     int n;
     double **data;
 } Matrix;
 
+// Laplacjan w formacie CSR - wiersz i to kolumny col[row_start[i] .. row_start[i + 1] - 1]
+typedef struct sparse_matrix {
+    int n;
+    int *row_start;
+    int *col;
+    double *val;
+    SellMatrix *sell;   // uklad SELL-C-sigma dla jader SIMD, NULL - jadro CSR
+} SparseMatrix;
+
 typedef struct entry {
     int index;
     double value;
@@ -16,10 +29,16 @@ Matrix* alloc_matrix(int n);
 void free_matrix(Matrix *m);
 Matrix* build_laplacian_matrix(int n);
 void normalize_vector(double *v, int n);
-void matvec_mul(Matrix *m, double *v, double *result);
+void matvec_mul(const SparseMatrix *m, const double *v, double *result);
 double vector_dot(const double *a, const double *b, int n);
-void power_iteration(Matrix *L, double *eigenvector, const int max_iter);
-int edge_cut_all(int vertex_count);
+void dense_eigenvectors(Matrix *L, int k, double *X);
+SparseMatrix *build_sparse_laplacian(int n);
+void free_sparse_matrix(SparseMatrix *m);
+// k najmniejszych wektorow wlasnych bez --eigen-cache (np. dla grafow zgrubnych metody ml)
+void compute_embedding(int vertex_count, int k, double *X, int warm_start);
+void spectral_embedding(int vertex_count, int k, double *X);
+void fiedler_vector(int vertex_count, double *eigenvector);
+int sweep_cut(const Entry *entries, int vertex_count, int min_size, int max_size);
 void spectral_partitioning(int parts, int vertex_count, double error_margin);
 
 
@@ -0,0 +1,297 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spmv.h"
+#include "thread_pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SPMV_X86 1
+#endif
+
+typedef enum simd_level {
+    SIMD_SCALAR,
+    SIMD_AVX2,
+    SIMD_AVX512
+} SimdLevel;
+
+static SimdLevel simd_level(void) {
+#ifdef SPMV_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return SIMD_AVX2;
+#endif
+    return SIMD_SCALAR;
+}
+
+typedef struct row_length {
+    int length;
+    int row;
+} RowLength;
+
+static int compare_row_length(const void *a, const void *b) {
+    const RowLength *ra = a, *rb = b;
+    if (ra->length != rb->length) return rb->length - ra->length;
+    return ra->row - rb->row;
+}
+
+SellMatrix *build_sell_matrix(int n, const int *row_start, const int *col, const double *val) {
+    SellMatrix *m = malloc(sizeof(SellMatrix));
+    int *lengths = malloc(n * sizeof(int));
+    if (!m || !lengths) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    m->n = n;
+    m->slices = (n + SELL_C - 1) / SELL_C;
+    m->perm = malloc(n * sizeof(int));
+    m->slice_start = malloc((m->slices + 1) * sizeof(long));
+    m->slice_width = malloc(m->slices * sizeof(int));
+    if (!m->perm || !m->slice_start || !m->slice_width) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    // sortowanie wierszy po dlugosci w oknach SELL_SIGMA ogranicza dopelnianie zerami
+    RowLength window[SELL_SIGMA];
+    for (int i = 0; i < n; i++) lengths[i] = row_start[i + 1] - row_start[i];
+    for (int w = 0; w < n; w += SELL_SIGMA) {
+        int count = (n - w < SELL_SIGMA) ? n - w : SELL_SIGMA;
+        for (int r = 0; r < count; r++) window[r] = (RowLength){ lengths[w + r], w + r };
+        qsort(window, count, sizeof(RowLength), compare_row_length);
+        for (int r = 0; r < count; r++) m->perm[w + r] = window[r].row;
+    }
+
+    long total = 0;
+    for (int s = 0; s < m->slices; s++) {
+        int width = 0;
+        for (int r = s * SELL_C; r < (s + 1) * SELL_C && r < n; r++) {
+            if (lengths[m->perm[r]] > width) width = lengths[m->perm[r]];
+        }
+        m->slice_start[s] = total;
+        m->slice_width[s] = width;
+        total += (long)width * SELL_C;
+    }
+    m->slice_start[m->slices] = total;
+
+    m->col = malloc((total + 1) * sizeof(int));
+    m->val = malloc((total + 1) * sizeof(double));
+    if (!m->col || !m->val) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+    for (int s = 0; s < m->slices; s++) {
+        for (int r = 0; r < SELL_C; r++) {
+            int row = s * SELL_C + r < n ? m->perm[s * SELL_C + r] : -1;
+            for (int j = 0; j < m->slice_width[s]; j++) {
+                long at = m->slice_start[s] + (long)j * SELL_C + r;
+                // dopelnienie: wartosc 0 i poprawny indeks kolumny, wiec gather nie wychodzi poza x
+                if (row != -1 && j < lengths[row]) {
+                    m->col[at] = col[row_start[row] + j];
+                    m->val[at] = val[row_start[row] + j];
+                } else {
+                    m->col[at] = 0;
+                    m->val[at] = 0;
+                }
+            }
+        }
+    }
+
+    free(lengths);
+    return m;
+}
+
+void free_sell_matrix(SellMatrix *m) {
+    free(m->slice_start);
+    free(m->slice_width);
+    free(m->perm);
+    free(m->col);
+    free(m->val);
+    free(m);
+}
+
+static void sell_slices_scalar(const SellMatrix *m, const double *x, double *y, int first, int last) {
+    for (int s = first; s < last; s++) {
+        double acc[SELL_C] = {0};
+        const int *c = m->col + m->slice_start[s];
+        const double *v = m->val + m->slice_start[s];
+        for (int j = 0; j < m->slice_width[s]; j++) {
+            for (int r = 0; r < SELL_C; r++) acc[r] += v[j * SELL_C + r] * x[c[j * SELL_C + r]];
+        }
+        for (int r = 0; r < SELL_C && s * SELL_C + r < m->n; r++) y[m->perm[s * SELL_C + r]] = acc[r];
+    }
+}
+
+#ifdef SPMV_X86
+__attribute__((target("avx2,fma")))
+static void sell_slices_avx2(const SellMatrix *m, const double *x, double *y, int first, int last) {
+    for (int s = first; s < last; s++) {
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        const int *c = m->col + m->slice_start[s];
+        const double *v = m->val + m->slice_start[s];
+        for (int j = 0; j < m->slice_width[s]; j++) {
+            __m128i i0 = _mm_loadu_si128((const __m128i *)(c + j * SELL_C));
+            __m128i i1 = _mm_loadu_si128((const __m128i *)(c + j * SELL_C + 4));
+            acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(v + j * SELL_C), _mm256_i32gather_pd(x, i0, 8), acc0);
+            acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(v + j * SELL_C + 4), _mm256_i32gather_pd(x, i1, 8), acc1);
+        }
+        double acc[SELL_C];
+        _mm256_storeu_pd(acc, acc0);
+        _mm256_storeu_pd(acc + 4, acc1);
+        for (int r = 0; r < SELL_C && s * SELL_C + r < m->n; r++) y[m->perm[s * SELL_C + r]] = acc[r];
+    }
+}
+
+__attribute__((target("avx512f")))
+static void sell_slices_avx512(const SellMatrix *m, const double *x, double *y, int first, int last) {
+    for (int s = first; s < last; s++) {
+        __m512d acc0 = _mm512_setzero_pd();
+        const int *c = m->col + m->slice_start[s];
+        const double *v = m->val + m->slice_start[s];
+        for (int j = 0; j < m->slice_width[s]; j++) {
+            __m256i idx = _mm256_loadu_si256((const __m256i *)(c + j * SELL_C));
+            acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(v + j * SELL_C), _mm512_i32gather_pd(idx, x, 8), acc0);
+        }
+        double acc[SELL_C];
+        _mm512_storeu_pd(acc, acc0);
+        for (int r = 0; r < SELL_C && s * SELL_C + r < m->n; r++) y[m->perm[s * SELL_C + r]] = acc[r];
+    }
+}
+#endif
+
+typedef struct spmv_job {
+    const SellMatrix *sell;
+    int n;
+    const int *row_start;
+    const int *col;
+    const double *val;
+    const double *x;
+    double *y;
+    int chunk;
+    SimdLevel level;
+} SpmvJob;
+
+static void sell_chunk_task(int index, void *arg) {
+    SpmvJob *job = arg;
+    int first = index * job->chunk;
+    int last = first + job->chunk < job->sell->slices ? first + job->chunk : job->sell->slices;
+#ifdef SPMV_X86
+    if (job->level == SIMD_AVX512) {
+        sell_slices_avx512(job->sell, job->x, job->y, first, last);
+        return;
+    }
+    if (job->level == SIMD_AVX2) {
+        sell_slices_avx2(job->sell, job->x, job->y, first, last);
+        return;
+    }
+#endif
+    sell_slices_scalar(job->sell, job->x, job->y, first, last);
+}
+
+static void csr_chunk_task(int index, void *arg) {
+    SpmvJob *job = arg;
+    int first = index * job->chunk;
+    int last = first + job->chunk < job->n ? first + job->chunk : job->n;
+    for (int i = first; i < last; i++) {
+        double sum = 0;
+        for (int k = job->row_start[i]; k < job->row_start[i + 1]; k++) sum += job->val[k] * job->x[job->col[k]];
+        job->y[i] = sum;
+    }
+}
+
+// bloki wierszy rozdzielane na watki tylko dla duzych macierzy
+static int chunk_count(long nnz, int units) {
+    if (nnz < SPMV_PARALLEL_NNZ) return 1;
+    int tasks = worker_count(units) * 4;
+    return tasks > units ? units : tasks;
+}
+
+void sell_spmv(const SellMatrix *m, const double *x, double *y) {
+    SpmvJob job = { .sell = m, .x = x, .y = y, .level = simd_level() };
+    int tasks = chunk_count(m->slice_start[m->slices], m->slices);
+    job.chunk = (m->slices + tasks - 1) / tasks;
+    if (tasks == 1) sell_chunk_task(0, &job);
+    else parallel_for(tasks, sell_chunk_task, &job);
+}
+
+void csr_spmv(int n, const int *row_start, const int *col, const double *val, const double *x, double *y) {
+    SpmvJob job = { .n = n, .row_start = row_start, .col = col, .val = val, .x = x, .y = y };
+    int tasks = chunk_count(row_start[n], n);
+    job.chunk = (n + tasks - 1) / tasks;
+    if (tasks == 1) csr_chunk_task(0, &job);
+    else parallel_for(tasks, csr_chunk_task, &job);
+}
+
+static double block_dot_scalar(const double *a, const double *b, int n) {
+    double acc[4] = {0};
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int l = 0; l < 4; l++) acc[l] += a[i + l] * b[i + l];
+    }
+    for (; i < n; i++) acc[0] += a[i] * b[i];
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+#ifdef SPMV_X86
+__attribute__((target("avx2,fma")))
+static double block_dot_avx2(const double *a, const double *b, int n) {
+    __m256d acc = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) acc = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), acc);
+    double lanes[4];
+    _mm256_storeu_pd(lanes, acc);
+    for (; i < n; i++) lanes[0] += a[i] * b[i];
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+#endif
+
+typedef struct dot_job {
+    const double *a;
+    const double *b;
+    int n;
+    double *partial;
+    SimdLevel level;
+} DotJob;
+
+static void dot_block_task(int index, void *arg) {
+    DotJob *job = arg;
+    int first = index * REDUCTION_BLOCK;
+    int len = job->n - first < REDUCTION_BLOCK ? job->n - first : REDUCTION_BLOCK;
+#ifdef SPMV_X86
+    if (job->level != SIMD_SCALAR) {
+        job->partial[index] = block_dot_avx2(job->a + first, job->b + first, len);
+        return;
+    }
+#endif
+    job->partial[index] = block_dot_scalar(job->a + first, job->b + first, len);
+}
+
+double dot_product(const double *a, const double *b, int n) {
+    int blocks = (n + REDUCTION_BLOCK - 1) / REDUCTION_BLOCK;
+    if (blocks == 0) return 0;
+
+    double stack_partial[64];
+    double *partial = blocks <= 64 ? stack_partial : malloc(blocks * sizeof(double));
+    if (!partial) {
+        printf("Blad pamieci.");
+        exit(15);
+    }
+
+    DotJob job = { a, b, n, partial, simd_level() };
+    // sumy blokow zawsze w tej samej kolejnosci - deterministyczny wynik przy dowolnej liczbie watkow
+    if ((long)n * 2 < SPMV_PARALLEL_NNZ) {
+        for (int k = 0; k < blocks; k++) dot_block_task(k, &job);
+    } else {
+        parallel_for(blocks, dot_block_task, &job);
+    }
+
+    double sum = 0;
+    for (int k = 0; k < blocks; k++) sum += partial[k];
+    if (partial != stack_partial) free(partial);
+    return sum;
+}
+
+void scale_vector(double *v, double factor, int n) {
+    for (int i = 0; i < n; i++) v[i] *= factor;
+}
@@ -0,0 +1,28 @@
+#ifndef SPMV_H
+#define SPMV_H
+
+#define SELL_C 8                      // wiersze w plasterku = 8 liczb double w rejestrze AVX-512
+#define SELL_SIGMA 256                // okno sortowania wierszy po dlugosci
+#define SPMV_PARALLEL_NNZ (1 << 18)   // ponizej tego rozmiaru koszt watkow przewyzsza zysk
+#define REDUCTION_BLOCK 4096          // staly podzial sumy - wynik niezalezny od liczby watkow
+
+// SELL-C-sigma: wiersze w plasterkach po SELL_C, wewnatrz plasterka dane kolumnami (element j wiersza r
+// pod slice_start[s] + j * SELL_C + r), krotsze wiersze dopelnione zerami
+typedef struct sell_matrix {
+    int n;
+    int slices;
+    long *slice_start;
+    int *slice_width;
+    int *perm;
+    int *col;
+    double *val;
+} SellMatrix;
+
+SellMatrix *build_sell_matrix(int n, const int *row_start, const int *col, const double *val);
+void free_sell_matrix(SellMatrix *m);
+void csr_spmv(int n, const int *row_start, const int *col, const double *val, const double *x, double *y);
+void sell_spmv(const SellMatrix *m, const double *x, double *y);
+double dot_product(const double *a, const double *b, int n);
+void scale_vector(double *v, double factor, int n);
+
+#endif //SPMV_H
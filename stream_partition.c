@@ -0,0 +1,296 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <sys/types.h>
+#include "graph_partition.h"
+#include "input_file.h"
+#include "output_file.h"
+#include "stream_partition.h"
+
+typedef struct stream_state {
+    int *group;     // -1 - wierzcholek jeszcze sie nie pojawil
+    int *sizes;
+    int *link;      // liczba sasiadow w kazdej grupie dla biezacego wierzcholka
+    int parts;
+    int target;
+    int margin;
+    int excess;     // suma nadwyzek grup ponad target - razem nie wiecej niz margin, zeby ostatnie grupy nie zostaly za male
+    int fennel;
+    double alpha;
+    FILE *out;
+    int binary;
+} StreamState;
+
+static void stream_error(void) {
+    printf("Blad: Niepoprawny format pliku. Plik musi zawierac przynajmniej 5 linii danych.\n");
+    exit(13);
+}
+
+// kolejna liczba z biezacej linii; 0 na koncu linii (znak nowej linii zostaje zjedzony) albo pliku
+static int read_value(FILE *f, int *val) {
+    int c = getc_unlocked(f);
+    while (c == ' ' || c == '\r') c = getc_unlocked(f);
+    if (c == '\n' || c == EOF) return 0;
+
+    int negative = 0;
+    if (c == '-') {
+        negative = 1;
+        c = getc_unlocked(f);
+    }
+    if ((unsigned)(c - '0') > 9) {
+        printf("Blad: Niepoprawny format pliku. Niedozwolony znak: '%c'. Znaki dozwolone to liczby i ';'.\n", c);
+        exit(13);
+    }
+    long v = 0;
+    while ((unsigned)(c - '0') <= 9) {
+        v = v * 10 + (c - '0');
+        if (v > INT_MAX) {
+            printf("Blad: Niepoprawny format pliku. Liczba poza zakresem.\n");
+            exit(13);
+        }
+        c = getc_unlocked(f);
+    }
+    while (c == ' ' || c == '\r') c = getc_unlocked(f);
+    if (c == '\n' || c == EOF) {
+        ungetc(c, f);
+    } else if (c != ';') {
+        printf("Blad: Niepoprawny format pliku. Niedozwolony znak: '%c'. Znaki dozwolone to liczby i ';'.\n", c);
+        exit(13);
+    }
+    *val = (int)(negative ? -v : v);
+    return 1;
+}
+
+static void skip_line(FILE *f) {
+    int c;
+    do c = getc_unlocked(f); while (c != '\n' && c != EOF);
+    if (c == EOF) stream_error();
+}
+
+// linia 4 przeczytana raz do walidacji i policzenia polaczen; przy stdin kopiowana do pliku tymczasowego
+static int scan_connections(FILE *in, FILE *copy, int vertex_count) {
+    int count = 0;
+    int val, prev = 0;
+    while (read_value(in, &val)) {
+        check_value(LINE_CONN, val, prev, count, vertex_count);
+        if (copy) fprintf(copy, "%d;", val);
+        prev = val;
+        count++;
+    }
+    if (copy) fputc('\n', copy);
+    if (count == 0) {
+        printf("Blad: Niepoprawny format pliku. Nie wczytano linii (sprawdz czy nie jest pusta).\n");
+        exit(13);
+    }
+    return count;
+}
+
+static int read_connection(FILE *conn) {
+    int val;
+    if (!read_value(conn, &val)) stream_error();
+    return val;
+}
+
+static void assign(StreamState *s, int v, int g) {
+    s->group[v] = g;
+    if (s->sizes[g]++ >= s->target) s->excess++;
+    write_stream_assignment(s->out, s->binary, v, g);
+}
+
+// najlepsza grupa wedlug LDG albo Fennel; grupa na lub ponad targetem przyjmuje wierzcholek tylko, dopoki laczna
+// nadwyzka miesci sie w marginesie. Remis - mniejsza grupa, potem nizszy numer
+static int best_part(const StreamState *s) {
+    int best = -1;
+    double best_score = 0;
+    for (int g = 0; g < s->parts; g++) {
+        if (s->sizes[g] >= s->target && s->excess >= s->margin) continue;
+        double score = s->fennel ? s->link[g] - s->alpha * FENNEL_GAMMA * pow(s->sizes[g], FENNEL_GAMMA - 1)
+                                 : s->link[g] * (1.0 - (double)s->sizes[g] / (s->target + s->margin));
+        if (best < 0 || score > best_score || (score == best_score && s->sizes[g] < s->sizes[best])) {
+            best = g;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+// grupa polaczen: pierwszy wierzcholek i jego sasiedzi; kazdy wierzcholek przypisany przy pierwszym pojawieniu sie,
+// na podstawie sasiadow znanych w tej chwili (dla nowych sasiadow jedynym znanym sasiadem jest pierwszy wierzcholek)
+static void place_group(StreamState *s, const int *members, int count) {
+    int head = members[0];
+    if (s->group[head] < 0) {
+        for (int j = 1; j < count; j++) {
+            if (s->group[members[j]] >= 0) s->link[s->group[members[j]]]++;
+        }
+        assign(s, head, best_part(s));
+        for (int j = 1; j < count; j++) {
+            if (s->group[members[j]] >= 0) s->link[s->group[members[j]]] = 0;
+        }
+    }
+
+    int g = s->group[head];
+    for (int j = 1; j < count; j++) {
+        if (s->group[members[j]] >= 0) continue;
+        s->link[g] = 1;
+        assign(s, members[j], best_part(s));
+        s->link[g] = 0;
+    }
+}
+
+void stream_partition(const char *input_file, const char *output_file, const char *format, const char *method, int parts, double error_margin, int choose_graph) {
+    if (!input_file || !output_file) {
+        printf("Blad: bledne dane wejsciowe.\n");
+        exit(14);
+    }
+    int from_stdin = strcmp(input_file, "-") == 0;
+    FILE *in = from_stdin ? stdin : fopen(input_file, "rb");
+    if (!in) {
+        printf("Blad: bledne dane wejsciowe.\n");
+        exit(14);
+    }
+    setvbuf(in, NULL, _IOFBF, STREAM_BUFFER);
+
+    int val, prev = 0;
+    if (!read_value(in, &max_matrix)) stream_error();
+    if ((!wide_flag && max_matrix > 1024) || max_matrix < 0) {
+        printf("Blad: Niepoprawny format pliku wejsciowego. Pierwsza linia pliku musi byc w przedziale 0-1024 (wieksze siatki wymagaja flagi --wide).");
+        exit(13);
+    }
+    skip_line(in);
+
+    // linie 2-3 tylko zliczane i sprawdzane - wspolrzedne nie sa potrzebne
+    int vertex_count = 0;
+    while (read_value(in, &val)) {
+        check_value(LINE_X, val, prev, vertex_count, 0);
+        vertex_count++;
+    }
+    int y_count = 0;
+    prev = 0;
+    while (read_value(in, &val)) {
+        check_value(LINE_Y, val, prev, y_count, 0);
+        prev = val;
+        y_count++;
+    }
+    if (vertex_count <= 0) {
+        printf("Blad: Niepoprawny format pliku wejsciowego. Liczba wierzcholkow z 2 linii musi byc wiesza niz 0.");
+        exit(13);
+    }
+    if (y_count == 0 || prev != vertex_count) {
+        printf("Blad: Niepoprawny format pliku wejsciowego. Obliczona ilosc wierzcholkow z 2 linii nie zgadza sie z iloscia z 3 linii.");
+        exit(13);
+    }
+    if (parts > vertex_count / 2) {
+        printf("Blad: Zbyt duza liczba podgrafow.");
+        exit(20);
+    }
+    if (vertex_count < 4) {
+        printf("Blad: graf jest zbyt maly, aby mozna bylo go podzielic.");
+        exit(18);
+    }
+
+    // linie 4 i 5 czytane w tym samym tempie: drugi uchwyt na pliku albo kopia linii 4 z stdin
+    FILE *conn;
+    int count_conn;
+    off_t conn_start = from_stdin ? -1 : ftello(in);
+    if (conn_start >= 0) {
+        conn = fopen(input_file, "rb");
+        if (!conn || setvbuf(conn, NULL, _IOFBF, STREAM_BUFFER) != 0 || fseeko(conn, conn_start, SEEK_SET) != 0) {
+            printf("Blad: bledne dane wejsciowe.\n");
+            exit(14);
+        }
+        count_conn = scan_connections(in, NULL, vertex_count);
+    } else {
+        conn = tmpfile();
+        if (!conn || setvbuf(conn, NULL, _IOFBF, STREAM_BUFFER) != 0) {
+            printf("Blad: bledne dane wejsciowe.\n");
+            exit(14);
+        }
+        count_conn = scan_connections(in, conn, vertex_count);
+        rewind(conn);
+    }
+    for (int g = 1; g < choose_graph; g++) skip_line(in);
+
+    StreamState s;
+    s.parts = parts;
+    s.fennel = strcmp(method, "fennel") == 0;
+    s.binary = strcmp(format, "binary") == 0;
+    int target = (vertex_count + parts - 1) / parts;
+    int margin = (error_margin < 0) ? 0 : (int)(target * error_margin / 100.0);
+    s.target = target;
+    s.margin = margin;
+    s.excess = 0;
+    // liczba krawedzi szacowana z linii 4 (polaczenia bez pierwszych wierzcholkow grup)
+    double edges = count_conn > vertex_count ? (double)(count_conn - vertex_count) : (double)vertex_count;
+    s.alpha = sqrt(parts) * edges / pow(vertex_count, FENNEL_GAMMA);
+    s.group = malloc(vertex_count * sizeof(int));
+    s.sizes = calloc(parts, sizeof(int));
+    s.link = calloc(parts, sizeof(int));
+    int member_capacity = 64;
+    int *members = malloc(member_capacity * sizeof(int));
+    if (!s.group || !s.sizes || !s.link || !members) {
+        printf("Blad pamieci.\n");
+        exit(15);
+    }
+    for (int i = 0; i < vertex_count; i++) s.group[i] = -1;
+
+    s.out = strcmp(output_file, "-") == 0 ? stdout : fopen(output_file, s.binary ? "wb" : "w");
+    if (!s.out) {
+        printf("Blad: bledne dane wejsciowe.\n");
+        exit(14);
+    }
+    setvbuf(s.out, NULL, _IOFBF, STREAM_BUFFER);
+    write_stream_header(s.out, s.binary, vertex_count, parts);
+
+    int offset;
+    if (!read_value(in, &offset)) {
+        printf("Blad: Niepoprawny format pliku. Nie wczytano linii (sprawdz czy nie jest pusta).\n");
+        exit(13);
+    }
+    check_value(LINE_OFFSETS, offset, 0, 0, count_conn);
+    for (int i = 0; i < offset; i++) read_connection(conn);
+
+    int count_offsets = 1;
+    int next;
+    while (read_value(in, &next)) {
+        check_value(LINE_OFFSETS, next, offset, count_offsets++, count_conn);
+        int count = next - offset;
+        if (count > member_capacity) {
+            while (member_capacity < count) member_capacity *= 2;
+            members = realloc(members, member_capacity * sizeof(int));
+            if (!members) {
+                printf("Blad pamieci.\n");
+                exit(15);
+            }
+        }
+        for (int j = 0; j < count; j++) members[j] = read_connection(conn);
+        if (count > 0) place_group(&s, members, count);
+        offset = next;
+    }
+
+    // wierzcholki bez polaczen - do najmniejszej grupy
+    for (int v = 0; v < vertex_count; v++) {
+        if (s.group[v] < 0) assign(&s, v, best_part(&s));
+    }
+
+    double ideal = (double)vertex_count / parts;
+    double worst = 0;
+    for (int g = 0; g < parts; g++) {
+        double deviation = fabs(s.sizes[g] - ideal) / ideal * 100.0;
+        if (deviation > worst) worst = deviation;
+    }
+    // przy wyniku na stdout komunikaty ida na stderr, zeby nie mieszac ich z przypisaniami
+    FILE *log = s.out == stdout ? stderr : stdout;
+    fprintf(log, "Nierownowaga grup: %.2f%%\n", worst);
+
+    if (s.out != stdout) fclose(s.out);
+    else fflush(s.out);
+    fprintf(log, "Podzial udany.");
+    if (!from_stdin) fclose(in);
+    fclose(conn);
+    free(s.group);
+    free(s.sizes);
+    free(s.link);
+    free(members);
+}
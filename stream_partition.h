@@ -0,0 +1,14 @@
+#ifndef STREAM_PARTITION_H
+#define STREAM_PARTITION_H
+
+#define STREAM_BUFFER (1 << 20)   // bufor odczytu i zapisu strumienia
+#define FENNEL_GAMMA 1.5
+
+// Podzial jednoprzebiegowy bez wczytywania grafu: grupy polaczen z linii 4 czytane sa strumieniowo razem z wybrana
+// linia offsetow, a kazdy wierzcholek dostaje grupe przy pierwszym pojawieniu sie - "ldg" (Linear Deterministic
+// Greedy): sasiedzi w grupie * (1 - rozmiar / pojemnosc), "fennel": sasiedzi w grupie - kara alfa * gamma * rozmiar^(gamma-1).
+// W pamieci zostaje tylko wektor grup, liczniki rozmiarow i jedna grupa polaczen; wynik zapisywany jest na biezaco.
+// input_file "-" oznacza stdin (linia 4 jest wtedy buforowana w pliku tymczasowym), output_file "-" - stdout.
+void stream_partition(const char *input_file, const char *output_file, const char *format, const char *method, int parts, double error_margin, int choose_graph);
+
+#endif //STREAM_PARTITION_H
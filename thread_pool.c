@@ -0,0 +1,124 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "thread_pool.h"
+
+// 0 - liczba watkow rowna liczbie dostepnych rdzeni
+int thread_count = 0;
+
+typedef struct parallel_job {
+    ParallelTask task;
+    void *arg;
+    int task_count;
+    int next;                       // pierwszy niepobrany indeks
+    int finished;
+    struct parallel_job *parent;    // zadanie, z wnetrza ktorego wywolano parallel_for (NULL - poziom glowny)
+    struct parallel_job *queued;    // nastepne zadanie w kolejce
+} ParallelJob;
+
+// stale watki robocze tworzone przy pierwszym wywolaniu; kolejka i liczniki zadan chronione przez pool_lock
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_cond = PTHREAD_COND_INITIALIZER;
+static int pool_size = -1;              // -1 - pula jeszcze nie utworzona
+static ParallelJob *pool_queue = NULL;  // zadania z niepobranymi indeksami, najnowsze na poczatku
+
+// zadanie, ktorego indeks wykonuje biezacy watek
+static _Thread_local ParallelJob *current_job = NULL;
+
+int worker_count(int task_count) {
+    int workers = thread_count;
+    if (workers <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cores > 0 ? (int)cores : 1;
+    }
+    if (workers > task_count) workers = task_count;
+    return workers < 1 ? 1 : workers;
+}
+
+static void unqueue(ParallelJob *job) {
+    ParallelJob **p = &pool_queue;
+    while (*p != job) p = &(*p)->queued;
+    *p = job->queued;
+}
+
+// czy job jest zadaniem owner albo zostal (posrednio) wywolany z jego wnetrza
+static int descends_from(const ParallelJob *job, const ParallelJob *owner) {
+    for (; job; job = job->parent) {
+        if (job == owner) return 1;
+    }
+    return 0;
+}
+
+// wykonuje jeden indeks zadania; wolane i konczone pod pool_lock
+static void run_one(ParallelJob *job) {
+    int index = job->next++;
+    if (job->next == job->task_count) unqueue(job);
+    pthread_mutex_unlock(&pool_lock);
+
+    ParallelJob *saved = current_job;
+    current_job = job;
+    job->task(index, job->arg);
+    current_job = saved;
+
+    pthread_mutex_lock(&pool_lock);
+    // zakonczenie budzi watek czekajacy na to zadanie
+    if (++job->finished == job->task_count) pthread_cond_broadcast(&pool_cond);
+}
+
+static void *pool_worker(void *data) {
+    (void)data;
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        if (pool_queue) run_one(pool_queue);
+        else pthread_cond_wait(&pool_cond, &pool_lock);
+    }
+    return NULL;
+}
+
+static void start_pool(void) {
+    int workers = worker_count(INT_MAX) - 1;
+    pool_size = 0;
+    for (int i = 0; i < workers; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, pool_worker, NULL) != 0) break;
+        pthread_detach(thread);
+        pool_size++;
+    }
+}
+
+void parallel_for(int task_count, ParallelTask task, void *arg) {
+    if (task_count <= 0) return;
+
+    pthread_mutex_lock(&pool_lock);
+    if (pool_size < 0) start_pool();
+    if (pool_size == 0 || task_count == 1) {
+        pthread_mutex_unlock(&pool_lock);
+        for (int i = 0; i < task_count; i++) task(i, arg);
+        return;
+    }
+
+    ParallelJob job;
+    job.task = task;
+    job.arg = arg;
+    job.task_count = task_count;
+    job.next = 0;
+    job.finished = 0;
+    job.parent = current_job;
+    job.queued = pool_queue;
+    pool_queue = &job;
+    pthread_cond_broadcast(&pool_cond);
+
+    // watek wywolujacy tez pracuje: najpierw nad wlasnymi indeksami, potem czekajac pomaga w zadaniach
+    // zagniezdzonych w tym wywolaniu (obce zadania moglyby nadpisac jego zmienne _Thread_local)
+    while (job.finished < job.task_count) {
+        ParallelJob *help = job.next < job.task_count ? &job : NULL;
+        for (ParallelJob *q = pool_queue; q && !help; q = q->queued) {
+            if (descends_from(q, &job)) help = q;
+        }
+        if (help) run_one(help);
+        else pthread_cond_wait(&pool_cond, &pool_lock);
+    }
+    pthread_mutex_unlock(&pool_lock);
+}
@@ -0,0 +1,15 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+typedef void (*ParallelTask)(int index, void *arg);
+
+extern int thread_count;
+
+int worker_count(int task_count);
+// Wykonuje task(0..task_count-1) na puli watkow. Czesc zadan trafia do watku wywolujacego,
+// wiec zadanie zmieniajace zmienne _Thread_local (np. vertices) musi je przywrocic. Pula (--threads - 1 watkow)
+// tworzona jest raz i wspolna dla wywolan zagniezdzonych: parallel_for z wnetrza zadania dodaje swoje indeksy do
+// kolejki, a watek czekajacy na ich koniec wykonuje indeksy tego wywolania i wywolan w nim zagniezdzonych.
+void parallel_for(int task_count, ParallelTask task, void *arg);
+
+#endif //THREAD_POOL_H